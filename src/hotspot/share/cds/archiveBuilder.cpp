@@ -25,12 +25,14 @@
 #include "precompiled.hpp"
 #include "cds/archiveBuilder.hpp"
 #include "cds/archiveHeapWriter.hpp"
-#include "cds/archiveUtils.hpp"
+#include "cds/archiveUtils.inline.hpp"
+#include "cds/cds_globals.hpp"
 #include "cds/cdsConfig.hpp"
 #include "cds/cppVtables.hpp"
 #include "cds/dumpAllocStats.hpp"
 #include "cds/dynamicArchive.hpp"
 #include "cds/heapShared.hpp"
+#include "cds/hotClassProfile.hpp"
 #include "cds/metaspaceShared.hpp"
 #include "cds/regeneratedClasses.hpp"
 #include "classfile/classLoaderDataShared.hpp"
@@ -41,6 +43,7 @@
 #include "interpreter/abstractInterpreter.hpp"
 #include "jvm.h"
 #include "logging/log.hpp"
+#include "logging/logMessage.hpp"
 #include "logging/logStream.hpp"
 #include "memory/allStatic.hpp"
 #include "memory/memRegion.hpp"
@@ -55,6 +58,7 @@
 #include "runtime/globals_extension.hpp"
 #include "runtime/javaThread.hpp"
 #include "runtime/sharedRuntime.hpp"
+#include "runtime/timerTrace.hpp"
 #include "utilities/align.hpp"
 #include "utilities/bitMap.inline.hpp"
 #include "utilities/formatBuffer.hpp"
@@ -130,7 +134,8 @@ class RelocateEmbeddedPointers : public BitMapClosure {
     log_trace(cds)("Ref: [" PTR_FORMAT "] -> " PTR_FORMAT " => " PTR_FORMAT,
                    p2i(ptr_loc), p2i(old_p), p2i(new_p));
 
-    ArchivePtrMarker::set_and_mark_pointer(ptr_loc, new_p);
+    // This is called by several threads, see relocate_embedded_pointers().
+    ArchivePtrMarker::par_set_and_mark_pointer(ptr_loc, new_p);
     return true; // keep iterating the bitmap
   }
 };
@@ -173,6 +178,7 @@ ArchiveBuilder::ArchiveBuilder() :
 {
   _klasses = new (mtClassShared) GrowableArray<Klass*>(4 * K, mtClassShared);
   _symbols = new (mtClassShared) GrowableArray<Symbol*>(256 * K, mtClassShared);
+  _num_hot_klasses = 0;
   _entropy_seed = 0x12345678;
   assert(_current == nullptr, "must be");
   _current = this;
@@ -281,6 +287,10 @@ void ArchiveBuilder::gather_klasses_and_symbols() {
     // TODO -- we need a proper estimate for the archived modules, etc,
     // but this should be enough for now
     _estimated_metaspaceobj_bytes += 200 * 1024 * 1024;
+  } else if (ArchiveLayoutProfile != nullptr) {
+    // The dynamic archive doesn't need a deterministic order, but the hot classes
+    // must still be moved to the front of _klasses.
+    sort_klasses();
   }
 }
 
@@ -297,9 +307,36 @@ int ArchiveBuilder::compare_klass_by_name(Klass** a, Klass** b) {
   return a[0]->name()->fast_compare(b[0]->name());
 }
 
+// Hot classes come first, in the order they were initialized in the training run.
+int ArchiveBuilder::compare_klass_by_rank_and_name(Klass** a, Klass** b) {
+  int rank_a = HotClassProfile::rank_of(a[0]);
+  int rank_b = HotClassProfile::rank_of(b[0]);
+  if (rank_a != rank_b) {
+    if (rank_a < 0) {
+      return 1;
+    } else if (rank_b < 0) {
+      return -1;
+    } else {
+      return rank_a - rank_b;
+    }
+  }
+  return compare_klass_by_name(a, b);
+}
+
 void ArchiveBuilder::sort_klasses() {
   log_info(cds)("Sorting classes ... ");
-  _klasses->sort(compare_klass_by_name);
+  HotClassProfile::load();
+  if (HotClassProfile::is_loaded()) {
+    _klasses->sort(compare_klass_by_rank_and_name);
+    _num_hot_klasses = 0;
+    while (_num_hot_klasses < _klasses->length() && HotClassProfile::is_hot(_klasses->at(_num_hot_klasses))) {
+      _num_hot_klasses++;
+    }
+    log_info(cds)("%d of %d classes are hot", _num_hot_klasses, _klasses->length());
+    HotClassProfile::unload();
+  } else {
+    _klasses->sort(compare_klass_by_name);
+  }
 }
 
 size_t ArchiveBuilder::estimate_archive_size() {
@@ -392,13 +429,32 @@ address ArchiveBuilder::reserve_buffer() {
 }
 
 void ArchiveBuilder::iterate_sorted_roots(MetaspaceClosure* it) {
+  // The Symbols must be visited first, in ascending address order: the archived
+  // method arrays are sorted by the addresses of the method names (see
+  // Method::sort_methods()), so the Symbols must keep their relative order.
   int num_symbols = _symbols->length();
   for (int i = 0; i < num_symbols; i++) {
     it->push(_symbols->adr_at(i));
   }
 
+  // Then visit the hot classes, and everything reachable from them, before
+  // the rest of the classes. Their metadata objects get the lowest IDs after
+  // the Symbols, so compare_src_objs() copies them ahead of the metadata that
+  // is rarely touched at runtime.
+  int num_gathered_rw = _rw_src_objs.objs()->length();
+  int num_gathered_ro = _ro_src_objs.objs()->length();
+  for (int i = 0; i < _num_hot_klasses; i++) {
+    it->push(_klasses->adr_at(i));
+  }
+  if (_num_hot_klasses > 0) {
+    it->finish();
+    log_info(cds)("Hot objects: rw = %d, ro = %d",
+                  _rw_src_objs.objs()->length() - num_gathered_rw,
+                  _ro_src_objs.objs()->length() - num_gathered_ro);
+  }
+
   int num_klasses = _klasses->length();
-  for (int i = 0; i < num_klasses; i++) {
+  for (int i = _num_hot_klasses; i < num_klasses; i++) {
     it->push(_klasses->adr_at(i));
   }
 
@@ -511,6 +567,7 @@ void ArchiveBuilder::remember_embedded_pointer_in_enclosing_obj(MetaspaceClosure
 }
 
 void ArchiveBuilder::gather_source_objs() {
+  TraceTime timer(nullptr, &_phase_timers[gather_phase]);
   ResourceMark rm;
   log_info(cds)("Gathering all archivable objects ... ");
   gather_klasses_and_symbols();
@@ -544,7 +601,7 @@ ArchiveBuilder::FollowMode ArchiveBuilder::get_follow_mode(MetaspaceClosure::Ref
     return point_to_it;
   } else if (ref->msotype() == MetaspaceObj::MethodDataType ||
              ref->msotype() == MetaspaceObj::MethodCountersType) {
-    return set_to_null;
+    return CDSConfig::is_dumping_method_profiles() ? make_a_copy : set_to_null;
   } else {
     if (ref->msotype() == MetaspaceObj::ClassType) {
       Klass* klass = (Klass*)ref->obj();
@@ -593,7 +650,10 @@ char* ArchiveBuilder::ro_strdup(const char* s) {
 
 // The objects that have embedded pointers will sink
 // towards the end of the list. This ensures we have a maximum
-// number of leading zero bits in the relocation bitmap.
+// number of leading zero bits in the relocation bitmap. Within
+// each group, objects are kept in the order they were gathered,
+// so the objects of the hot classes (see iterate_sorted_roots())
+// stay at the front.
 int ArchiveBuilder::compare_src_objs(SourceObjInfo** a, SourceObjInfo** b) {
   if ((*a)->has_embedded_pointer() && !(*b)->has_embedded_pointer()) {
     return 1;
@@ -644,15 +704,31 @@ void ArchiveBuilder::dump_ro_metadata() {
   RegeneratedClasses::record_regenerated_objects();
 }
 
+// The buffered copies are allocated serially, in the order of src_objs, so the layout
+// of the archive does not depend on the number of threads. Only the contents of the
+// objects are copied in parallel.
 void ArchiveBuilder::make_shallow_copies(DumpRegion *dump_region,
                                          const ArchiveBuilder::SourceObjList* src_objs) {
-  for (int i = 0; i < src_objs->objs()->length(); i++) {
-    make_shallow_copy(dump_region, src_objs->objs()->at(i));
+  TraceTime timer(nullptr, &_phase_timers[copy_phase]);
+  GrowableArray<SourceObjInfo*>* objs = src_objs->objs();
+  for (int i = 0; i < objs->length(); i++) {
+    allocate_shallow_copy(dump_region, objs->at(i));
   }
-  log_info(cds)("done (%d objects)", src_objs->objs()->length());
+
+  ArchiveUtils::parallel_for(objs->length(), 1024, [&](size_t beg, size_t end) {
+    for (size_t i = beg; i < end; i++) {
+      SourceObjInfo* src_info = objs->at((int)i);
+      memcpy(src_info->buffered_addr(), src_info->source_addr(), src_info->size_in_bytes());
+    }
+  });
+
+  for (int i = 0; i < objs->length(); i++) {
+    finish_shallow_copy(objs->at(i));
+  }
+  log_info(cds)("done (%d objects)", objs->length());
 }
 
-void ArchiveBuilder::make_shallow_copy(DumpRegion *dump_region, SourceObjInfo* src_info) {
+void ArchiveBuilder::allocate_shallow_copy(DumpRegion *dump_region, SourceObjInfo* src_info) {
   address src = src_info->source_addr();
   int bytes = src_info->size_in_bytes();
   char* dest;
@@ -674,15 +750,6 @@ void ArchiveBuilder::make_shallow_copy(DumpRegion *dump_region, SourceObjInfo* s
   dest = dump_region->allocate(bytes);
   newtop = dump_region->top();
 
-  memcpy(dest, src, bytes);
-
-  // Update the hash of buffered sorted symbols for static dump so that the symbols have deterministic contents
-  if (CDSConfig::is_dumping_static_archive() && (src_info->msotype() == MetaspaceObj::SymbolType)) {
-    Symbol* buffered_symbol = (Symbol*)dest;
-    assert(((Symbol*)src)->is_permanent(), "archived symbols must be permanent");
-    buffered_symbol->update_identity_hash();
-  }
-
   {
     bool created;
     _buffered_to_src_table.put_if_absent((address)dest, src, &created);
@@ -692,18 +759,31 @@ void ArchiveBuilder::make_shallow_copy(DumpRegion *dump_region, SourceObjInfo* s
     }
   }
 
-  intptr_t* archived_vtable = CppVtables::get_archived_vtable(src_info->msotype(), (address)dest);
-  if (archived_vtable != nullptr) {
-    *(address*)dest = (address)archived_vtable;
-    ArchivePtrMarker::mark_pointer((address*)dest);
-  }
-
   log_trace(cds)("Copy: " PTR_FORMAT " ==> " PTR_FORMAT " %d", p2i(src), p2i(dest), bytes);
   src_info->set_buffered_addr((address)dest);
 
   _alloc_stats.record(src_info->msotype(), int(newtop - oldtop), src_info->read_only());
 }
 
+// Called after the contents of src_info have been copied into the buffer.
+void ArchiveBuilder::finish_shallow_copy(SourceObjInfo* src_info) {
+  address dest = src_info->buffered_addr();
+
+  // Update the hash of buffered sorted symbols for static dump so that the symbols have deterministic contents.
+  // This must be done serially, in the order of the sorted objects, as the hash comes from entropy().
+  if (CDSConfig::is_dumping_static_archive() && (src_info->msotype() == MetaspaceObj::SymbolType)) {
+    Symbol* buffered_symbol = (Symbol*)dest;
+    assert(((Symbol*)src_info->source_addr())->is_permanent(), "archived symbols must be permanent");
+    buffered_symbol->update_identity_hash();
+  }
+
+  intptr_t* archived_vtable = CppVtables::get_archived_vtable(src_info->msotype(), dest);
+  if (archived_vtable != nullptr) {
+    *(address*)dest = (address)archived_vtable;
+    ArchivePtrMarker::mark_pointer((address*)dest);
+  }
+}
+
 // This is used by code that hand-assembles data structures, such as the LambdaProxyClassKey, that are
 // not handled by MetaspaceClosure.
 void ArchiveBuilder::write_pointer_in_buffer(address* ptr_location, address src_addr) {
@@ -732,14 +812,20 @@ address ArchiveBuilder::get_source_addr(address buffered_addr) const {
   return *src_p;
 }
 
+// Each object is relocated independently. The ptrmap is updated with par_set_bit(),
+// as adjacent objects may share a word of the bitmap.
 void ArchiveBuilder::relocate_embedded_pointers(ArchiveBuilder::SourceObjList* src_objs) {
-  for (int i = 0; i < src_objs->objs()->length(); i++) {
-    src_objs->relocate(i, this);
-  }
+  ArchiveUtils::parallel_for(src_objs->objs()->length(), 1024, [&](size_t beg, size_t end) {
+    for (size_t i = beg; i < end; i++) {
+      src_objs->relocate((int)i, this);
+    }
+  });
 }
 
 void ArchiveBuilder::relocate_metaspaceobj_embedded_pointers() {
+  TraceTime timer(nullptr, &_phase_timers[relocate_embedded_phase]);
   log_info(cds)("Relocating embedded pointers in core regions ... ");
+  ArchivePtrMarker::expand_ptrmap((address*)_ro_region.top());
   relocate_embedded_pointers(&_rw_src_objs);
   relocate_embedded_pointers(&_ro_src_objs);
 }
@@ -887,7 +973,6 @@ class RelocateBufferToRequested : public BitMapClosure {
   address _buffer_bottom;
   intx _buffer_to_requested_delta;
   intx _mapped_to_requested_static_archive_delta;
-  size_t _max_non_null_offset;
 
  public:
   RelocateBufferToRequested(ArchiveBuilder* builder) {
@@ -895,7 +980,6 @@ class RelocateBufferToRequested : public BitMapClosure {
     _buffer_bottom = _builder->buffer_bottom();
     _buffer_to_requested_delta = builder->buffer_to_requested_delta();
     _mapped_to_requested_static_archive_delta = builder->requested_static_archive_bottom() - builder->mapped_static_archive_bottom();
-    _max_non_null_offset = 0;
 
     address bottom = _builder->buffer_bottom();
     address top = _builder->buffer_top();
@@ -913,7 +997,7 @@ class RelocateBufferToRequested : public BitMapClosure {
 
     if (*p == nullptr) {
       // todo -- clear bit, etc
-      ArchivePtrMarker::ptrmap()->clear_bit(offset);
+      ArchivePtrMarker::ptrmap()->par_clear_bit(offset);
     } else {
       if (STATIC_DUMP) {
         assert(_builder->is_in_buffer_space(*p), "old pointer must point inside buffer space");
@@ -929,20 +1013,28 @@ class RelocateBufferToRequested : public BitMapClosure {
           assert(_builder->is_in_requested_static_archive(*p), "new pointer must point inside requested archive");
         }
       }
-      _max_non_null_offset = offset;
     }
 
     return true; // keep iterating
   }
 
   void doit() {
-    ArchivePtrMarker::ptrmap()->iterate(this);
-    ArchivePtrMarker::compact(_max_non_null_offset);
+    // The pointers are patched in parallel. The bits of null pointers are cleared
+    // with par_clear_bit(), as a word of the ptrmap may be shared by two chunks.
+    CHeapBitMap* ptrmap = ArchivePtrMarker::ptrmap();
+    ArchiveUtils::parallel_for(ptrmap->size(), 64 * K, [&](size_t beg, size_t end) {
+      ptrmap->iterate(this, beg, end);
+    });
+
+    // All remaining bits are for non-null pointers.
+    BitMap::idx_t max_non_null_offset = ptrmap->find_last_set_bit(0);
+    ArchivePtrMarker::compact(max_non_null_offset == ptrmap->size() ? 0 : max_non_null_offset);
   }
 };
 
 
 void ArchiveBuilder::relocate_to_requested() {
+  TraceTime timer(nullptr, &_phase_timers[relocate_to_requested_phase]);
   ro_region()->pack();
 
   size_t my_archive_size = buffer_top() - buffer_bottom();
@@ -1300,6 +1392,29 @@ class ArchiveBuilder::CDSMapLogger : AllStatic {
 
 void ArchiveBuilder::print_stats() {
   _alloc_stats.print_stats(int(_ro_region.used()), int(_rw_region.used()));
+  print_phase_stats();
+}
+
+void ArchiveBuilder::print_phase_stats() {
+  static const char* phase_names[num_dump_phases] = {
+    "Gather source objs",
+    "Copy objs",
+    "Relocate embedded",
+    "Relocate to requested",
+    "Write archive"
+  };
+
+  LogMessage(cds) msg;
+  msg.debug("Dump phases:");
+  double total = 0;
+  for (int i = 0; i < num_dump_phases; i++) {
+    total += _phase_timers[i].seconds();
+  }
+  for (int i = 0; i < num_dump_phases; i++) {
+    double secs = _phase_timers[i].seconds();
+    msg.debug("%-22s: %8.3f ms %5.1f%%", phase_names[i], secs * 1000.0, percent_of(secs, total));
+  }
+  msg.debug("%-22s: %8.3f ms", "Total", total * 1000.0);
 }
 
 void ArchiveBuilder::write_archive(FileMapInfo* mapinfo, ArchiveHeapInfo* heap_info) {
@@ -1307,6 +1422,8 @@ void ArchiveBuilder::write_archive(FileMapInfo* mapinfo, ArchiveHeapInfo* heap_i
   // MetaspaceShared::n_regions (internal to hotspot).
   assert(NUM_CDS_REGIONS == MetaspaceShared::n_regions, "sanity");
 
+  _phase_timers[write_phase].start();
+
   write_region(mapinfo, MetaspaceShared::rw, &_rw_region, /*read_only=*/false,/*allow_exec=*/false);
   write_region(mapinfo, MetaspaceShared::ro, &_ro_region, /*read_only=*/true, /*allow_exec=*/false);
 
@@ -1329,6 +1446,7 @@ void ArchiveBuilder::write_archive(FileMapInfo* mapinfo, ArchiveHeapInfo* heap_i
   // would corrupt its checksum we have calculated before.
   mapinfo->write_header();
   mapinfo->close();
+  _phase_timers[write_phase].stop();
 
   if (log_is_enabled(Info, cds)) {
     print_stats();
@@ -31,6 +31,7 @@
 #include "oops/array.hpp"
 #include "oops/klass.hpp"
 #include "runtime/os.hpp"
+#include "runtime/timer.hpp"
 #include "utilities/bitMap.hpp"
 #include "utilities/growableArray.hpp"
 #include "utilities/resizeableResourceHash.hpp"
@@ -226,13 +227,26 @@ class ArchiveBuilder : public StackObj {
   ResizeableResourceHashtable<address, address, AnyObj::C_HEAP, mtClassShared> _buffered_to_src_table;
   GrowableArray<Klass*>* _klasses;
   GrowableArray<Symbol*>* _symbols;
+  int _num_hot_klasses;                       // the first _num_hot_klasses of _klasses are listed
+                                              // in the HotClassProfile
   unsigned int _entropy_seed;
 
   // statistics
   DumpAllocStats _alloc_stats;
   size_t _total_heap_region_size;
 
+  enum DumpPhase {
+    gather_phase,
+    copy_phase,
+    relocate_embedded_phase,
+    relocate_to_requested_phase,
+    write_phase,
+    num_dump_phases
+  };
+  elapsedTimer _phase_timers[num_dump_phases];
+
   void print_region_stats(FileMapInfo *map_info, ArchiveHeapInfo* heap_info);
+  void print_phase_stats();
   void print_bitmap_region_stats(size_t size, size_t total_size);
   void print_heap_region_stats(ArchiveHeapInfo* heap_info, size_t total_size);
 
@@ -258,9 +272,11 @@ class ArchiveBuilder : public StackObj {
   void sort_klasses();
   static int compare_symbols_by_address(Symbol** a, Symbol** b);
   static int compare_klass_by_name(Klass** a, Klass** b);
+  static int compare_klass_by_rank_and_name(Klass** a, Klass** b);
 
   void make_shallow_copies(DumpRegion *dump_region, const SourceObjList* src_objs);
-  void make_shallow_copy(DumpRegion *dump_region, SourceObjInfo* src_info);
+  void allocate_shallow_copy(DumpRegion *dump_region, SourceObjInfo* src_info);
+  void finish_shallow_copy(SourceObjInfo* src_info);
 
   void relocate_embedded_pointers(SourceObjList* src_objs);
 
@@ -24,6 +24,7 @@
 
 #include "precompiled.hpp"
 #include "cds/archiveHeapLoader.inline.hpp"
+#include "cds/archiveHeapWriter.hpp"
 #include "cds/cdsConfig.hpp"
 #include "cds/heapShared.hpp"
 #include "cds/metaspaceShared.hpp"
@@ -36,6 +37,7 @@
 #include "memory/universe.hpp"
 #include "utilities/bitMap.inline.hpp"
 #include "utilities/copy.hpp"
+#include "utilities/powerOfTwo.hpp"
 
 #if INCLUDE_CDS_JAVA_HEAP
 
@@ -53,6 +55,9 @@ uintptr_t ArchiveHeapLoader::_dumptime_base = UINTPTR_MAX;
 uintptr_t ArchiveHeapLoader::_dumptime_top = 0;
 intx ArchiveHeapLoader::_runtime_offset = 0;
 bool ArchiveHeapLoader::_loading_failed = false;
+intx* ArchiveHeapLoader::_slice_offsets = nullptr;
+size_t ArchiveHeapLoader::_num_slices = 0;
+int ArchiveHeapLoader::_slice_shift = 0;
 
 // Support for mapped heap.
 uintptr_t ArchiveHeapLoader::_mapped_heap_bottom = 0;
@@ -219,35 +224,35 @@ void ArchiveHeapLoader::init_loaded_heap_relocation(LoadedArchiveHeapRegion* loa
 }
 
 bool ArchiveHeapLoader::can_load() {
-  if (!UseCompressedOops) {
-    // Pointer relocation for uncompressed oops is unimplemented.
-    return false;
-  }
+  // With !UseCompressedOops, the oopmap records the location of every full-width oop
+  // field, which is relocated by PatchLoadedRegionPointers<oop>.
   return Universe::heap()->can_load_archived_objects();
 }
 
+// This is called after init_loaded_heap_relocation(), so decode_from_archive() and
+// to_loaded_address() return the runtime address of the referenced object.
+template <typename T>
 class ArchiveHeapLoader::PatchLoadedRegionPointers: public BitMapClosure {
-  narrowOop* _start;
-  intx _offset;
-  uintptr_t _base;
-  uintptr_t _top;
-
- public:
-  PatchLoadedRegionPointers(narrowOop* start, LoadedArchiveHeapRegion* loaded_region)
-    : _start(start),
-      _offset(loaded_region->_runtime_offset),
-      _base(loaded_region->_dumptime_base),
-      _top(loaded_region->top()) {}
+  T* _start;
 
-  bool do_bit(size_t offset) {
-    assert(UseCompressedOops, "PatchLoadedRegionPointers for uncompressed oops is unimplemented");
-    narrowOop* p = _start + offset;
+  static uintptr_t relocated(narrowOop* p) {
     narrowOop v = *p;
     assert(!CompressedOops::is_null(v), "null oops should have been filtered out at dump time");
-    uintptr_t o = cast_from_oop<uintptr_t>(ArchiveHeapLoader::decode_from_archive(v));
-    assert(_base <= o && o < _top, "must be");
+    return cast_from_oop<uintptr_t>(ArchiveHeapLoader::decode_from_archive(v));
+  }
 
-    o += _offset;
+  static uintptr_t relocated(oop* p) {
+    uintptr_t dumptime_oop = (uintptr_t)((void*)*p);
+    assert(dumptime_oop != 0, "null oops should have been filtered out at dump time");
+    return ArchiveHeapLoader::to_loaded_address(dumptime_oop);
+  }
+
+ public:
+  PatchLoadedRegionPointers(T* start) : _start(start) {}
+
+  bool do_bit(size_t offset) {
+    T* p = _start + offset;
+    uintptr_t o = relocated(p);
     ArchiveHeapLoader::assert_in_loaded_heap(o);
     RawAccess<IS_NOT_NULL>::oop_store(p, cast_to_oop(o));
     return true;
@@ -271,6 +276,11 @@ bool ArchiveHeapLoader::init_loaded_region(FileMapInfo* mapinfo, LoadedArchiveHe
 
   assert(is_aligned(total_bytes, HeapWordSize), "must be");
   size_t word_size = total_bytes / HeapWordSize;
+  size_t max_word_size = Universe::heap()->max_loaded_archive_space_word_size();
+  if (word_size > max_word_size) {
+    return init_loaded_slices(loaded_region, max_word_size * HeapWordSize);
+  }
+
   HeapWord* buffer = Universe::heap()->allocate_loaded_archive_space(word_size);
   if (buffer == nullptr) {
     return false;
@@ -285,6 +295,74 @@ bool ArchiveHeapLoader::init_loaded_region(FileMapInfo* mapinfo, LoadedArchiveHe
   return true;
 }
 
+// The GC can only give us blocks of up to max_slice_bytes (e.g., a ZGC small page), so
+// the region is loaded in slices. Each slice starts at a multiple of
+// ArchiveHeapWriter::MIN_GC_REGION_ALIGNMENT from the bottom of the region. No archived
+// object crosses such a boundary, so every slice is a parsable sequence of objects.
+bool ArchiveHeapLoader::init_loaded_slices(LoadedArchiveHeapRegion* loaded_region, size_t max_slice_bytes) {
+  const size_t min_slice_bytes = ArchiveHeapWriter::MIN_GC_REGION_ALIGNMENT;
+  if (max_slice_bytes < min_slice_bytes) {
+    log_info(cds)("Cannot load heap region: GC allocation limit (" SIZE_FORMAT " bytes) is too small",
+                  max_slice_bytes);
+    return false;
+  }
+
+  // MIN_GC_REGION_ALIGNMENT is a power of two, so slice_bytes is a multiple of it.
+  const size_t slice_bytes = round_down_power_of_2(max_slice_bytes);
+  const size_t region_size = loaded_region->_region_size;
+  const size_t num_slices = align_up(region_size, slice_bytes) / slice_bytes;
+
+  _slice_shift = log2i_exact(slice_bytes);
+  _slice_offsets = NEW_C_HEAP_ARRAY(intx, num_slices, mtClassShared);
+  _num_slices = 0;
+
+  // The slices are always relocated by to_loaded_address(), so these are set here
+  // to let fill_failed_loaded_heap() find the slices that have been allocated so far.
+  _dumptime_base = loaded_region->_dumptime_base;
+  _dumptime_top = loaded_region->top();
+
+  for (size_t i = 0; i < num_slices; i++) {
+    size_t offset = i * slice_bytes;
+    size_t byte_size = MIN2(slice_bytes, region_size - offset);
+    HeapWord* buffer = Universe::heap()->allocate_loaded_archive_space(byte_size / HeapWordSize);
+    if (buffer == nullptr) {
+      // There's no easy way to free the slices that have already been allocated. They
+      // will be filled in fill_failed_loaded_heap().
+      log_warning(cds)("Allocation of heap region slice " SIZE_FORMAT " has failed. Archived objects are disabled", i);
+      _loading_failed = true;
+      return false;
+    }
+    _slice_offsets[i] = (intx)((uintptr_t)buffer - (loaded_region->_dumptime_base + offset));
+    _num_slices = i + 1;
+  }
+
+  log_info(cds)("Loading heap region in " SIZE_FORMAT " slices of " SIZE_FORMAT " bytes", _num_slices, slice_bytes);
+  return true;
+}
+
+MemRegion ArchiveHeapLoader::loaded_slice(size_t i) {
+  if (!is_loaded_in_slices()) {
+    assert(i == 0, "must be");
+    return MemRegion((HeapWord*)_loaded_heap_bottom, (HeapWord*)_loaded_heap_top);
+  }
+  assert(i < _num_slices, "must be");
+  size_t offset = i << _slice_shift;
+  size_t byte_size = MIN2(size_t(1) << _slice_shift, (_dumptime_top - _dumptime_base) - offset);
+  HeapWord* bottom = (HeapWord*)(_dumptime_base + offset + _slice_offsets[i]);
+  return MemRegion(bottom, byte_size / HeapWordSize);
+}
+
+bool ArchiveHeapLoader::is_in_loaded_heap(uintptr_t o) {
+  for (size_t i = 0; i < num_loaded_slices(); i++) {
+    if (loaded_slice(i).contains((void*)o)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// If the region is loaded in slices, load_address is a temporary buffer. The objects are
+// relocated inside this buffer, and then copied into the slices.
 bool ArchiveHeapLoader::load_heap_region_impl(FileMapInfo* mapinfo, LoadedArchiveHeapRegion* loaded_region,
                                               uintptr_t load_address) {
   uintptr_t bitmap_base = (uintptr_t)mapinfo->map_bitmap_region();
@@ -302,22 +380,44 @@ bool ArchiveHeapLoader::load_heap_region_impl(FileMapInfo* mapinfo, LoadedArchiv
     return false;
   }
   assert(r->mapped_base() == (char*)load_address, "sanity");
-  log_info(cds)("Loaded heap    region #%d at base " INTPTR_FORMAT " top " INTPTR_FORMAT
-                " size " SIZE_FORMAT_W(6) " delta " INTX_FORMAT,
-                loaded_region->_region_index, load_address, load_address + loaded_region->_region_size,
-                loaded_region->_region_size, loaded_region->_runtime_offset);
+  if (!is_loaded_in_slices()) {
+    log_info(cds)("Loaded heap    region #%d at base " INTPTR_FORMAT " top " INTPTR_FORMAT
+                  " size " SIZE_FORMAT_W(6) " delta " INTX_FORMAT,
+                  loaded_region->_region_index, load_address, load_address + loaded_region->_region_size,
+                  loaded_region->_region_size, loaded_region->_runtime_offset);
+  }
 
   uintptr_t oopmap = bitmap_base + r->oopmap_offset();
   BitMapView bm((BitMap::bm_word_t*)oopmap, r->oopmap_size_in_bits());
 
-  PatchLoadedRegionPointers patcher((narrowOop*)load_address + FileMapInfo::current_info()->heap_oopmap_start_pos(), loaded_region);
-  bm.iterate(&patcher);
+  if (UseCompressedOops) {
+    PatchLoadedRegionPointers<narrowOop> patcher((narrowOop*)load_address + FileMapInfo::current_info()->heap_oopmap_start_pos());
+    bm.iterate(&patcher);
+  } else {
+    PatchLoadedRegionPointers<oop> patcher((oop*)load_address + FileMapInfo::current_info()->heap_oopmap_start_pos());
+    bm.iterate(&patcher);
+  }
+
+  if (is_loaded_in_slices()) {
+    for (size_t i = 0; i < _num_slices; i++) {
+      MemRegion slice = loaded_slice(i);
+      HeapWord* from = (HeapWord*)(load_address + (i << _slice_shift));
+      Copy::disjoint_words(from, slice.start(), slice.word_size());
+      log_info(cds)("Loaded heap    region #%d slice " SIZE_FORMAT " at base " INTPTR_FORMAT " top " INTPTR_FORMAT
+                    " size " SIZE_FORMAT_W(6) " delta " INTX_FORMAT,
+                    loaded_region->_region_index, i, p2i(slice.start()), p2i(slice.end()),
+                    slice.byte_size(), _slice_offsets[i]);
+    }
+    // The region is no longer contiguous in memory. Use to_loaded_address() instead.
+    r->set_mapped_base(nullptr);
+  }
   return true;
 }
 
 bool ArchiveHeapLoader::load_heap_region(FileMapInfo* mapinfo) {
-  assert(UseCompressedOops, "loaded heap for !UseCompressedOops is unimplemented");
-  init_narrow_oop_decoding(mapinfo->narrow_oop_base(), mapinfo->narrow_oop_shift());
+  if (UseCompressedOops) {
+    init_narrow_oop_decoding(mapinfo->narrow_oop_base(), mapinfo->narrow_oop_shift());
+  }
 
   LoadedArchiveHeapRegion loaded_region;
   memset(&loaded_region, 0, sizeof(loaded_region));
@@ -327,12 +427,24 @@ bool ArchiveHeapLoader::load_heap_region(FileMapInfo* mapinfo) {
     return false;
   }
 
-  if (!load_heap_region_impl(mapinfo, &loaded_region, (uintptr_t)archive_space.start())) {
+  // Pointers are relocated with decode_from_archive() and to_loaded_address(), which
+  // need the relocation info.
+  init_loaded_heap_relocation(&loaded_region);
+
+  bool success;
+  if (is_loaded_in_slices()) {
+    char* buffer = NEW_C_HEAP_ARRAY(char, loaded_region._region_size, mtClassShared);
+    success = load_heap_region_impl(mapinfo, &loaded_region, (uintptr_t)buffer);
+    FREE_C_HEAP_ARRAY(char, buffer);
+  } else {
+    success = load_heap_region_impl(mapinfo, &loaded_region, (uintptr_t)archive_space.start());
+  }
+
+  if (!success) {
     assert(_loading_failed, "must be");
     return false;
   }
 
-  init_loaded_heap_relocation(&loaded_region);
   _is_loaded = true;
 
   return true;
@@ -356,33 +468,42 @@ class VerifyLoadedHeapEmbeddedPointers: public BasicOopIterateClosure {
     }
   }
   virtual void do_oop(oop* p) {
-    // Uncompressed oops are not supported by loaded heaps.
-    Unimplemented();
+    // Same as above. The collector has not yet converted the pointers to its own
+    // format, so they can be read as plain addresses.
+    uintptr_t u = (uintptr_t)((void*)*p);
+    if (u != 0) {
+      ArchiveHeapLoader::assert_in_loaded_heap(u);
+      guarantee(_table->contains(u), "must point to beginning of object in loaded archived region");
+    }
   }
 };
 
 void ArchiveHeapLoader::finish_initialization() {
   if (is_loaded()) {
     // These operations are needed only when the heap is loaded (not mapped).
-    finish_loaded_heap();
+    // The verification must be done before complete_loaded_archive_space(), which
+    // may convert the embedded pointers to a collector-specific format.
     if (VerifyArchivedFields > 0) {
       verify_loaded_heap();
     }
+    finish_loaded_heap();
   }
   if (is_in_use()) {
     patch_native_pointers();
-    intptr_t bottom = is_loaded() ? _loaded_heap_bottom : _mapped_heap_bottom;
-    intptr_t roots_oop = bottom + FileMapInfo::current_info()->heap_roots_offset();
+    intptr_t roots_oop;
+    if (is_loaded()) {
+      roots_oop = to_loaded_address(_dumptime_base + FileMapInfo::current_info()->heap_roots_offset());
+    } else {
+      roots_oop = _mapped_heap_bottom + FileMapInfo::current_info()->heap_roots_offset();
+    }
     HeapShared::init_roots(cast_to_oop(roots_oop));
   }
 }
 
 void ArchiveHeapLoader::finish_loaded_heap() {
-  HeapWord* bottom = (HeapWord*)_loaded_heap_bottom;
-  HeapWord* top    = (HeapWord*)_loaded_heap_top;
-
-  MemRegion archive_space = MemRegion(bottom, top);
-  Universe::heap()->complete_loaded_archive_space(archive_space);
+  for (size_t i = 0; i < num_loaded_slices(); i++) {
+    Universe::heap()->complete_loaded_archive_space(loaded_slice(i));
+  }
 }
 
 void ArchiveHeapLoader::verify_loaded_heap() {
@@ -391,25 +512,34 @@ void ArchiveHeapLoader::verify_loaded_heap() {
   ResourceMark rm;
   ResourceHashtable<uintptr_t, bool> table;
   VerifyLoadedHeapEmbeddedPointers verifier(&table);
-  HeapWord* bottom = (HeapWord*)_loaded_heap_bottom;
-  HeapWord* top    = (HeapWord*)_loaded_heap_top;
 
-  for (HeapWord* p = bottom; p < top; ) {
-    oop o = cast_to_oop(p);
-    table.put(cast_from_oop<uintptr_t>(o), true);
-    p += o->size();
+  for (size_t i = 0; i < num_loaded_slices(); i++) {
+    MemRegion slice = loaded_slice(i);
+    for (HeapWord* p = slice.start(); p < slice.end(); ) {
+      oop o = cast_to_oop(p);
+      table.put(cast_from_oop<uintptr_t>(o), true);
+      p += o->size();
+    }
   }
 
-  for (HeapWord* p = bottom; p < top; ) {
-    oop o = cast_to_oop(p);
-    o->oop_iterate(&verifier);
-    p += o->size();
+  for (size_t i = 0; i < num_loaded_slices(); i++) {
+    MemRegion slice = loaded_slice(i);
+    for (HeapWord* p = slice.start(); p < slice.end(); ) {
+      oop o = cast_to_oop(p);
+      o->oop_iterate(&verifier);
+      p += o->size();
+    }
   }
 }
 
 void ArchiveHeapLoader::fill_failed_loaded_heap() {
   assert(_loading_failed, "must be");
-  if (_loaded_heap_bottom != 0) {
+  if (is_loaded_in_slices()) {
+    for (size_t i = 0; i < _num_slices; i++) {
+      MemRegion slice = loaded_slice(i);
+      Universe::heap()->fill_with_objects(slice.start(), slice.word_size());
+    }
+  } else if (_loaded_heap_bottom != 0) {
     assert(_loaded_heap_top != 0, "must be");
     HeapWord* bottom = (HeapWord*)_loaded_heap_bottom;
     HeapWord* top = (HeapWord*)_loaded_heap_top;
@@ -417,6 +547,14 @@ void ArchiveHeapLoader::fill_failed_loaded_heap() {
   }
 }
 
+static void patch_native_pointer(Metadata** p) {
+  *p = (Metadata*)(address(*p) + MetaspaceShared::relocation_delta());
+  // Currently we have only Klass pointers in heap objects.
+  // This needs to be relaxed when we support other types of native
+  // pointers such as Method.
+  assert(((Klass*)(*p))->is_klass(), "must be");
+}
+
 class PatchNativePointers: public BitMapClosure {
   Metadata** _start;
 
@@ -424,12 +562,22 @@ class PatchNativePointers: public BitMapClosure {
   PatchNativePointers(Metadata** start) : _start(start) {}
 
   bool do_bit(size_t offset) {
-    Metadata** p = _start + offset;
-    *p = (Metadata*)(address(*p) + MetaspaceShared::relocation_delta());
-    // Currently we have only Klass pointers in heap objects.
-    // This needs to be relaxed when we support other types of native
-    // pointers such as Method.
-    assert(((Klass*)(*p))->is_klass(), "must be");
+    patch_native_pointer(_start + offset);
+    return true;
+  }
+};
+
+// The loaded heap may not be contiguous, so every location is translated
+// with ArchiveHeapLoader::to_loaded_address().
+class PatchLoadedNativePointers: public BitMapClosure {
+  uintptr_t _dumptime_start;
+
+ public:
+  PatchLoadedNativePointers(uintptr_t dumptime_start) : _dumptime_start(dumptime_start) {}
+
+  bool do_bit(size_t offset) {
+    uintptr_t dumptime_addr = _dumptime_start + offset * sizeof(Metadata*);
+    patch_native_pointer((Metadata**)ArchiveHeapLoader::to_loaded_address(dumptime_addr));
     return true;
   }
 };
@@ -440,10 +588,19 @@ void ArchiveHeapLoader::patch_native_pointers() {
   }
 
   FileMapRegion* r = FileMapInfo::current_info()->region_at(MetaspaceShared::hp);
-  if (r->mapped_base() != nullptr && r->has_ptrmap()) {
+  if (!r->has_ptrmap()) {
+    return;
+  }
+
+  size_t start_pos = FileMapInfo::current_info()->heap_ptrmap_start_pos();
+  BitMapView bm = FileMapInfo::current_info()->ptrmap_view(MetaspaceShared::hp);
+  if (is_loaded()) {
+    log_info(cds, heap)("Patching native pointers in loaded heap region");
+    PatchLoadedNativePointers patcher(_dumptime_base + start_pos * sizeof(Metadata*));
+    bm.iterate(&patcher);
+  } else if (r->mapped_base() != nullptr) {
     log_info(cds, heap)("Patching native pointers in heap region");
-    BitMapView bm = FileMapInfo::current_info()->ptrmap_view(MetaspaceShared::hp);
-    PatchNativePointers patcher((Metadata**)r->mapped_base() + FileMapInfo::current_info()->heap_ptrmap_start_pos());
+    PatchNativePointers patcher((Metadata**)r->mapped_base() + start_pos);
     bm.iterate(&patcher);
   }
 }
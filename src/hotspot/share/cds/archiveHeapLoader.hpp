@@ -91,6 +91,10 @@ class ArchiveHeapLoader : AllStatic {
   // More efficient version, but works only when ArchiveHeap is mapped.
   inline static oop decode_from_mapped_archive(narrowOop v) NOT_CDS_JAVA_HEAP_RETURN_(nullptr);
 
+  // is_loaded() only: translate the dump-time address of a location inside the archived
+  // heap region to the address where it has been loaded at runtime.
+  inline static uintptr_t to_loaded_address(uintptr_t dumptime_addr) NOT_CDS_JAVA_HEAP_RETURN_(0);
+
   static void patch_compressed_embedded_pointers(BitMapView bm,
                                                  FileMapInfo* info,
                                                  MemRegion region) NOT_CDS_JAVA_HEAP_RETURN;
@@ -117,6 +121,15 @@ class ArchiveHeapLoader : AllStatic {
   static uintptr_t _loaded_heap_top;
   static bool _loading_failed;
 
+  // If the GC cannot allocate a single block that's large enough for the whole region
+  // (see CollectedHeap::max_loaded_archive_space_word_size()), the region is loaded in
+  // slices of (1 << _slice_shift) bytes. The i-th slice is loaded at an offset of
+  // _slice_offsets[i] from its dump time address. In this case, _loaded_heap_{bottom,top}
+  // and _runtime_offset are not used.
+  static intx*  _slice_offsets;
+  static size_t _num_slices;
+  static int    _slice_shift;
+
   // UseCompressedOops only: Used by decode_from_archive
   static bool    _narrow_oop_base_initialized;
   static address _narrow_oop_base;
@@ -131,6 +144,7 @@ class ArchiveHeapLoader : AllStatic {
   static void init_narrow_oop_decoding(address base, int shift);
   static bool init_loaded_region(FileMapInfo* mapinfo, LoadedArchiveHeapRegion* loaded_region,
                                  MemRegion& archive_space);
+  static bool init_loaded_slices(LoadedArchiveHeapRegion* loaded_region, size_t max_slice_bytes);
   static bool load_heap_region_impl(FileMapInfo* mapinfo, LoadedArchiveHeapRegion* loaded_region, uintptr_t buffer);
   static void init_loaded_heap_relocation(LoadedArchiveHeapRegion* reloc_info);
   static void patch_native_pointers();
@@ -138,14 +152,21 @@ class ArchiveHeapLoader : AllStatic {
   static void verify_loaded_heap();
   static void fill_failed_loaded_heap();
 
-  static bool is_in_loaded_heap(uintptr_t o) {
-    return (_loaded_heap_bottom <= o && o < _loaded_heap_top);
+  static bool is_loaded_in_slices() {
+    return _slice_offsets != nullptr;
+  }
+  static size_t num_loaded_slices() {
+    return is_loaded_in_slices() ? _num_slices : 1;
   }
+  // The runtime address range of the i-th slice of the loaded heap. If the heap was
+  // loaded contiguously, there's a single slice that covers the whole loaded heap.
+  static MemRegion loaded_slice(size_t i);
+  static bool is_in_loaded_heap(uintptr_t o);
 
   template<bool IS_MAPPED>
   inline static oop decode_from_archive_impl(narrowOop v) NOT_CDS_JAVA_HEAP_RETURN_(nullptr);
 
-  class PatchLoadedRegionPointers;
+  template <typename T> class PatchLoadedRegionPointers;
 
 public:
 
@@ -40,8 +40,7 @@ inline oop ArchiveHeapLoader::decode_from_archive_impl(narrowOop v) {
   if (IS_MAPPED) {
     assert(_dumptime_base == UINTPTR_MAX, "must be");
   } else if (p >= _dumptime_base) {
-    assert(p < _dumptime_top, "must be");
-    p += _runtime_offset;
+    p = to_loaded_address(p);
   }
 
   oop result = cast_to_oop((uintptr_t)p);
@@ -49,6 +48,15 @@ inline oop ArchiveHeapLoader::decode_from_archive_impl(narrowOop v) {
   return result;
 }
 
+inline uintptr_t ArchiveHeapLoader::to_loaded_address(uintptr_t dumptime_addr) {
+  assert(_dumptime_base <= dumptime_addr && dumptime_addr < _dumptime_top, "must be");
+  if (!is_loaded_in_slices()) {
+    return dumptime_addr + _runtime_offset;
+  } else {
+    return dumptime_addr + _slice_offsets[(dumptime_addr - _dumptime_base) >> _slice_shift];
+  }
+}
+
 inline oop ArchiveHeapLoader::decode_from_archive(narrowOop v) {
   return decode_from_archive_impl<false>(v);
 }
@@ -35,9 +35,12 @@
 #include "cds/metaspaceShared.hpp"
 #include "classfile/systemDictionaryShared.hpp"
 #include "classfile/vmClasses.hpp"
+#include "gc/shared/collectedHeap.hpp"
+#include "gc/shared/workerThread.hpp"
 #include "interpreter/bootstrapInfo.hpp"
 #include "memory/metaspaceUtils.hpp"
 #include "memory/resourceArea.hpp"
+#include "memory/universe.hpp"
 #include "oops/compressedOops.inline.hpp"
 #include "runtime/arguments.hpp"
 #include "utilities/bitMap.inline.hpp"
@@ -127,6 +130,32 @@ void ArchivePtrMarker::mark_pointer(address* ptr_loc) {
   }
 }
 
+void ArchivePtrMarker::par_mark_pointer(address* ptr_loc) {
+  assert(_ptrmap != nullptr, "not initialized");
+  assert(!_compacted, "cannot mark anymore");
+
+  if (ptr_base() <= ptr_loc && ptr_loc < ptr_end()) {
+    address value = *ptr_loc;
+    assert(value != (address)ptr_base(), "don't point to the bottom of the archive");
+
+    if (value != nullptr) {
+      assert(uintx(ptr_loc) % sizeof(intptr_t) == 0, "pointers must be stored in aligned addresses");
+      size_t idx = ptr_loc - ptr_base();
+      assert(idx < _ptrmap->size(), "ptrmap must have been expanded");
+      _ptrmap->par_set_bit(idx);
+    }
+  }
+}
+
+void ArchivePtrMarker::expand_ptrmap(address* limit) {
+  assert(_ptrmap != nullptr, "not initialized");
+  assert(ptr_base() <= limit && limit <= ptr_end(), "must be");
+  size_t size = limit - ptr_base();
+  if (_ptrmap->size() < size) {
+    _ptrmap->resize(size);
+  }
+}
+
 void ArchivePtrMarker::clear_pointer(address* ptr_loc) {
   assert(_ptrmap != nullptr, "not initialized");
   assert(!_compacted, "cannot clear anymore");
@@ -369,3 +398,76 @@ void ArchiveUtils::log_to_classlist(BootstrapInfo* bootstrap_specifier, TRAPS) {
     }
   }
 }
+
+// The following is adapted from crc32_combine() in zlib, which uses the same
+// polynomial as ClassLoader::crc32(). The CRC operator for a run of zero bits is
+// a 32x32 matrix over GF(2), and appending len2 zero bytes to A is computed by
+// repeated squaring of that matrix.
+static juint gf2_matrix_times(const juint* mat, juint vec) {
+  juint sum = 0;
+  while (vec != 0) {
+    if ((vec & 1) != 0) {
+      sum ^= *mat;
+    }
+    vec >>= 1;
+    mat++;
+  }
+  return sum;
+}
+
+static void gf2_matrix_square(juint* square, const juint* mat) {
+  for (int n = 0; n < 32; n++) {
+    square[n] = gf2_matrix_times(mat, mat[n]);
+  }
+}
+
+int ArchiveUtils::crc32_combine(int crc1, int crc2, size_t len2) {
+  if (len2 == 0) {
+    return crc1;
+  }
+
+  juint even[32]; // even-power-of-two zeros operator
+  juint odd[32];  // odd-power-of-two zeros operator
+
+  // Operator for one zero bit in odd
+  odd[0] = 0xedb88320; // CRC-32 polynomial
+  juint row = 1;
+  for (int n = 1; n < 32; n++) {
+    odd[n] = row;
+    row <<= 1;
+  }
+
+  gf2_matrix_square(even, odd); // two zero bits
+  gf2_matrix_square(odd, even); // four zero bits
+
+  // Apply len2 zero bytes to crc1 (the first square puts the operator for one
+  // zero byte, eight zero bits, in even).
+  juint crc = (juint)crc1;
+  do {
+    gf2_matrix_square(even, odd);
+    if ((len2 & 1) != 0) {
+      crc = gf2_matrix_times(even, crc);
+    }
+    len2 >>= 1;
+    if (len2 == 0) {
+      break;
+    }
+
+    gf2_matrix_square(odd, even);
+    if ((len2 & 1) != 0) {
+      crc = gf2_matrix_times(odd, crc);
+    }
+    len2 >>= 1;
+  } while (len2 != 0);
+
+  return (int)(crc ^ (juint)crc2);
+}
+
+void ArchiveUtils::run_chunked_task(WorkerTask* task, size_t num_chunks) {
+  WorkerThreads* workers = Universe::heap() != nullptr ? Universe::heap()->safepoint_workers() : nullptr;
+  if (workers != nullptr && num_chunks > 1) {
+    workers->run_task(task, (uint)MIN2(num_chunks, (size_t)workers->max_workers()));
+  } else {
+    task->work(0);
+  }
+}
@@ -35,6 +35,7 @@
 class BootstrapInfo;
 class ReservedSpace;
 class VirtualSpace;
+class WorkerTask;
 
 // ArchivePtrMarker is used to mark the location of pointers embedded in a CDS archive. E.g., when an
 // InstanceKlass k is dumped, we mark the location of the k->_name pointer by effectively calling
@@ -58,6 +59,11 @@ class ArchivePtrMarker : AllStatic {
   static void initialize_rw_ro_maps(CHeapBitMap* rw_ptrmap, CHeapBitMap* ro_ptrmap);
   static void mark_pointer(address* ptr_loc);
   static void clear_pointer(address* ptr_loc);
+
+  // Same as mark_pointer(), but can be called by several threads at the same time.
+  // The ptrmap is not resized, so it must first be expanded with expand_ptrmap().
+  static void par_mark_pointer(address* ptr_loc);
+  static void expand_ptrmap(address* limit);
   static void compact(address relocatable_base, address relocatable_end);
   static void compact(size_t max_non_null_offset);
 
@@ -72,6 +78,12 @@ class ArchivePtrMarker : AllStatic {
     mark_pointer(ptr_loc);
   }
 
+  template <typename T>
+  static void par_set_and_mark_pointer(T* ptr_loc, T ptr_value) {
+    *ptr_loc = ptr_value;
+    par_mark_pointer((address*)ptr_loc);
+  }
+
   static CHeapBitMap* ptrmap() {
     return _ptrmap;
   }
@@ -248,6 +260,21 @@ class ReadClosure : public SerializeClosure {
 class ArchiveUtils {
 public:
   static void log_to_classlist(BootstrapInfo* bootstrap_specifier, TRAPS) NOT_CDS_RETURN;
+
+  // Given crc1 = ClassLoader::crc32(0, A, lenA) and crc2 = ClassLoader::crc32(0, B, len2),
+  // returns the CRC of the concatenation of A and B. This allows the CRC of a large
+  // block to be computed in independent chunks.
+  static int crc32_combine(int crc1, int crc2, size_t len2);
+
+  // Runs a task whose work is split into num_chunks chunks on the GC's safepoint
+  // workers, or on the current thread if there are no workers or only one chunk.
+  // The task claims the chunks itself.
+  static void run_chunked_task(WorkerTask* task, size_t num_chunks);
+
+  // Calls function(beg, end) for consecutive ranges of at most chunk_size indices
+  // that cover [0, length). The ranges may be processed in parallel and in any order.
+  template <typename Function>
+  static void parallel_for(size_t length, size_t chunk_size, Function function);
 };
 
 #endif // SHARE_CDS_ARCHIVEUTILS_HPP
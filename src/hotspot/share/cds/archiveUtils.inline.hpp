@@ -27,6 +27,9 @@
 
 #include "cds/archiveUtils.hpp"
 
+#include "gc/shared/workerThread.hpp"
+#include "runtime/atomic.hpp"
+#include "utilities/align.hpp"
 #include "utilities/bitMap.inline.hpp"
 
 inline bool SharedDataRelocator::do_bit(size_t offset) {
@@ -47,4 +50,41 @@ inline bool SharedDataRelocator::do_bit(size_t offset) {
   return true; // keep iterating
 }
 
+template <typename Function>
+class ArchiveParallelForTask : public WorkerTask {
+  const size_t    _length;
+  const size_t    _chunk_size;
+  Function        _function;
+  volatile size_t _next;
+
+public:
+  ArchiveParallelForTask(size_t length, size_t chunk_size, Function function) :
+    WorkerTask("CDS Parallel For"),
+    _length(length),
+    _chunk_size(chunk_size),
+    _function(function),
+    _next(0) {}
+
+  size_t num_chunks() const {
+    return align_up(_length, _chunk_size) / _chunk_size;
+  }
+
+  void work(uint worker_id) {
+    while (true) {
+      size_t beg = Atomic::fetch_then_add(&_next, _chunk_size);
+      if (beg >= _length) {
+        return;
+      }
+      _function(beg, MIN2(beg + _chunk_size, _length));
+    }
+  }
+};
+
+template <typename Function>
+void ArchiveUtils::parallel_for(size_t length, size_t chunk_size, Function function) {
+  assert(chunk_size > 0, "must be");
+  ArchiveParallelForTask<Function> task(length, chunk_size, function);
+  run_chunked_task(&task, task.num_chunks());
+}
+
 #endif // SHARE_CDS_ARCHIVEUTILS_INLINE_HPP
@@ -396,6 +396,11 @@ bool CDSConfig::is_logging_lambda_form_invokers() {
   return ClassListWriter::is_enabled() || is_dumping_dynamic_archive();
 }
 
+bool CDSConfig::is_dumping_method_profiles() {
+  // Profiles only exist after a training run, so they are stored in the dynamic archive only.
+  return ArchiveMethodProfiles && is_dumping_dynamic_archive();
+}
+
 void CDSConfig::stop_using_optimized_module_handling() {
   _is_using_optimized_module_handling = false;
   _is_dumping_full_module_graph = false; // This requires is_using_optimized_module_handling()
@@ -42,6 +42,11 @@
   product(bool, VerifySharedSpaces, false,                                  \
           "Verify integrity of shared spaces")                              \
                                                                             \
+  product(bool, CompressSharedArchive, false, EXPERIMENTAL,                 \
+          "Compress the rw and ro regions when dumping a CDS archive. "     \
+          "Compressed regions are decompressed at startup instead of "      \
+          "being mapped")                                                   \
+                                                                            \
   product(bool, RecordDynamicDumpInfo, false,                               \
           "Record class info for jcmd VM.cds dynamic_dump")                 \
                                                                             \
@@ -75,9 +80,49 @@
           "Dump the names all loaded classes, that could be stored into "   \
           "the CDS archive, in the specified file")                         \
                                                                             \
+  product(ccstr, DumpArchiveLayoutProfile, nullptr, DIAGNOSTIC,             \
+          "Record the names of the classes in the order they are "          \
+          "initialized in the specified file, for use with "                \
+          "ArchiveLayoutProfile")                                           \
+                                                                            \
+  product(ccstr, ArchiveLayoutProfile, nullptr, DIAGNOSTIC,                 \
+          "When dumping a CDS archive, place the metadata of the classes "  \
+          "listed in the specified file (see DumpArchiveLayoutProfile) "    \
+          "at the beginning of the rw and ro regions")                      \
+                                                                            \
   product(ccstr, SharedClassListFile, nullptr,                              \
           "Override the default CDS class list")                            \
                                                                             \
+  product(uint, ClassListPreloadThreads, 0, DIAGNOSTIC,                     \
+          "Number of threads used during -Xshare:dump to load and link "    \
+          "the classes of the built-in loaders in the classlist before "    \
+          "the classlist is parsed. 0 means the classes are loaded "        \
+          "serially by the parsing thread. The contents of the archive "    \
+          "may not be reproducible when this is enabled")                   \
+          range(0, 256)                                                     \
+                                                                            \
+  product(bool, PrelinkLambdaCallSites, false, DIAGNOSTIC,                   \
+          "When dumping the static CDS archive, link all the "              \
+          "LambdaMetafactory call sites in the archived classes, so that "  \
+          "the lambda proxy classes of all of them are archived, not only " \
+          "those listed in the classlist")                                  \
+                                                                            \
+  product(bool, ArchiveMethodProfiles, false, DIAGNOSTIC,                   \
+          "When dumping the dynamic CDS archive, also archive the "         \
+          "MethodData and MethodCounters collected during the run, so "     \
+          "that the JIT compilers can use them early in the next run")     \
+                                                                            \
+  product(bool, PrecompileTrainedMethods, false, DIAGNOSTIC,                \
+          "When a class from a dynamic CDS archive dumped with "            \
+          "ArchiveMethodProfiles is initialized, immediately request C2 "   \
+          "compilations of its methods that were C2-compiled in the "       \
+          "run that dumped the archive")                                    \
+                                                                            \
+  product(bool, PregenerateArchivedAdapters, false, DIAGNOSTIC,             \
+          "At startup, create the i2c/c2i adapters of all the signatures "  \
+          "recorded in the static CDS archive in a few large code blobs, "  \
+          "instead of one blob per adapter when each class is linked")      \
+                                                                            \
   product(ccstr, SharedArchiveFile, nullptr,                                \
           "Override the default location of the CDS archive file")          \
                                                                             \
@@ -48,6 +48,8 @@
 #include "runtime/handles.inline.hpp"
 #include "runtime/java.hpp"
 #include "runtime/javaCalls.hpp"
+#include "runtime/javaThread.hpp"
+#include "runtime/mutexLocker.hpp"
 #include "utilities/defaultStream.hpp"
 #include "utilities/macros.hpp"
 #include "utilities/utf8.hpp"
@@ -91,6 +93,130 @@ FILE* ClassListParser::do_open(const char* file) {
   return fp;
 }
 
+// Shared state of the threads started by ClassListParser::preload_in_parallel().
+class ParallelClassPreloader : public StackObj {
+  GrowableArray<Symbol*>* _class_names;
+  volatile int _next;
+  int _num_running;      // Protected by _lock
+  int _num_loaded;       // Protected by _lock
+  Monitor* _lock;
+
+  static ParallelClassPreloader* _current;
+
+  static void thread_entry(JavaThread* thread, TRAPS) {
+    _current->work(thread);
+  }
+
+  void work(JavaThread* current) {
+    int num_loaded = 0;
+    while (true) {
+      int i = Atomic::fetch_then_add(&_next, 1);
+      if (i >= _class_names->length()) {
+        break;
+      }
+      HandleMark hm(current);
+      ResourceMark rm(current);
+      ExceptionMark em(current);
+      JavaThread* THREAD = current; // For exception macros.
+      Klass* k = ClassListParser::load_builtin_class(_class_names->at(i), THREAD);
+      if (HAS_PENDING_EXCEPTION) {
+        // The error will be reported when the parsing thread loads this class again.
+        CLEAR_PENDING_EXCEPTION;
+        continue;
+      }
+      num_loaded++;
+      if (k->is_instance_klass() && MetaspaceShared::may_be_eagerly_linked(InstanceKlass::cast(k))) {
+        // Verification failures are recorded in SystemDictionaryShared, so the
+        // class won't be linked again by the parsing thread.
+        MetaspaceShared::try_link_class(current, InstanceKlass::cast(k));
+      }
+    }
+
+    MonitorLocker ml(current, _lock);
+    _num_loaded += num_loaded;
+    _num_running--;
+    ml.notify_all();
+  }
+
+public:
+  ParallelClassPreloader(GrowableArray<Symbol*>* class_names) :
+    _class_names(class_names), _next(0), _num_running(0), _num_loaded(0),
+    _lock(new Monitor(Mutex::safepoint, "ParallelClassPreloader_lock")) {
+    assert(_current == nullptr, "only one preloader at a time");
+    _current = this;
+  }
+
+  ~ParallelClassPreloader() {
+    delete _lock;
+    _current = nullptr;
+  }
+
+  void run(uint num_threads, TRAPS) {
+    for (uint i = 0; i < num_threads; i++) {
+      char name[64];
+      jio_snprintf(name, sizeof(name), "CDS Class Preloader#%u", i);
+      Handle thread_oop = JavaThread::create_system_thread_object(name, THREAD);
+      if (HAS_PENDING_EXCEPTION) {
+        // Whatever is not preloaded will be loaded by the parsing thread.
+        log_warning(cds)("Cannot start class preloading thread #%u", i);
+        CLEAR_PENDING_EXCEPTION;
+        break;
+      }
+      JavaThread* thread = new JavaThread(&thread_entry);
+      JavaThread::vm_exit_on_osthread_failure(thread);
+      {
+        MonitorLocker ml(THREAD, _lock);
+        _num_running++;
+      }
+      JavaThread::start_internal_daemon(THREAD, thread, thread_oop, NormPriority);
+    }
+
+    MonitorLocker ml(THREAD, _lock);
+    while (_num_running > 0) {
+      ml.wait();
+    }
+  }
+
+  int num_loaded() const { return _num_loaded; }
+};
+
+ParallelClassPreloader* ParallelClassPreloader::_current = nullptr;
+
+void ClassListParser::preload_in_parallel(const char* classlist_path, uint num_threads, TRAPS) {
+  FileInput file_input(do_open(classlist_path), /* need_close=*/true);
+  if (!file_input.is_open()) {
+    // The parsing thread will report the error.
+    return;
+  }
+
+  GrowableArray<Symbol*>* class_names = new (mtClass) GrowableArray<Symbol*>(4 * K, mtClass);
+  inputStream input_stream(&file_input);
+  for (; !input_stream.done(); input_stream.next()) {
+    char* line = input_stream.current_line();
+    if (*line == '#' || *line == '@' || strstr(line, " source:") != nullptr) {
+      // Comments, @ tags and classes for unregistered loaders are handled by the parsing thread only.
+      continue;
+    }
+    size_t len = strcspn(line, " \t\r\n\f");
+    if (len == 0 || len > (size_t)Symbol::max_length() || *line == JVM_SIGNATURE_ARRAY) {
+      continue;
+    }
+    class_names->append(SymbolTable::new_symbol(line, (int)len));
+  }
+
+  log_info(cds)("Preloading %d classes with %u threads ...", class_names->length(), num_threads);
+  {
+    ParallelClassPreloader preloader(class_names);
+    preloader.run(num_threads, THREAD);
+    log_info(cds)("Preloading classes: done (%d loaded)", preloader.num_loaded());
+  }
+
+  for (int i = 0; i < class_names->length(); i++) {
+    class_names->at(i)->decrement_refcount();
+  }
+  delete class_names;
+}
+
 bool ClassListParser::is_parsing_thread() {
   return Atomic::load(&_parsing_thread) == Thread::current();
 }
@@ -621,6 +747,35 @@ void ClassListParser::resolve_indy_impl(Symbol* class_name_symbol, TRAPS) {
   }
 }
 
+Klass* ClassListParser::load_builtin_class(Symbol* class_name_symbol, TRAPS) {
+  if (Signature::is_array(class_name_symbol)) {
+    // array classes are not supported in class list.
+    THROW_NULL(vmSymbols::java_lang_ClassNotFoundException());
+  }
+
+  JavaValue result(T_OBJECT);
+  // Call java_system_loader().loadClass() directly, which will
+  // delegate to the correct loader (boot, platform or app) depending on
+  // the package name.
+
+  // ClassLoader.loadClass() wants external class name format, i.e., convert '/' chars to '.'
+  Handle ext_class_name = java_lang_String::externalize_classname(class_name_symbol, CHECK_NULL);
+  Handle loader = Handle(THREAD, SystemDictionary::java_system_loader());
+
+  JavaCalls::call_virtual(&result,
+                          loader, //SystemDictionary::java_system_loader(),
+                          vmClasses::ClassLoader_klass(),
+                          vmSymbols::loadClass_name(),
+                          vmSymbols::string_class_signature(),
+                          ext_class_name,
+                          CHECK_NULL);
+
+  assert(result.get_type() == T_OBJECT, "just checking");
+  oop obj = result.get_oop();
+  assert(obj != nullptr, "jdk.internal.loader.BuiltinClassLoader::loadClass never returns null");
+  return java_lang_Class::as_Klass(obj);
+}
+
 Klass* ClassListParser::load_current_class(Symbol* class_name_symbol, TRAPS) {
   Klass* klass;
   if (!is_loading_from_source()) {
@@ -632,32 +787,7 @@ Klass* ClassListParser::load_current_class(Symbol* class_name_symbol, TRAPS) {
       error("If source location is not specified, interface(s) must not be specified");
     }
 
-    if (Signature::is_array(class_name_symbol)) {
-      // array classes are not supported in class list.
-      THROW_NULL(vmSymbols::java_lang_ClassNotFoundException());
-    }
-
-    JavaValue result(T_OBJECT);
-    // Call java_system_loader().loadClass() directly, which will
-    // delegate to the correct loader (boot, platform or app) depending on
-    // the package name.
-
-    // ClassLoader.loadClass() wants external class name format, i.e., convert '/' chars to '.'
-    Handle ext_class_name = java_lang_String::externalize_classname(class_name_symbol, CHECK_NULL);
-    Handle loader = Handle(THREAD, SystemDictionary::java_system_loader());
-
-    JavaCalls::call_virtual(&result,
-                            loader, //SystemDictionary::java_system_loader(),
-                            vmClasses::ClassLoader_klass(),
-                            vmSymbols::loadClass_name(),
-                            vmSymbols::string_class_signature(),
-                            ext_class_name,
-                            CHECK_NULL);
-
-    assert(result.get_type() == T_OBJECT, "just checking");
-    oop obj = result.get_oop();
-    assert(obj != nullptr, "jdk.internal.loader.BuiltinClassLoader::loadClass never returns null");
-    klass = java_lang_Class::as_Klass(obj);
+    klass = load_builtin_class(class_name_symbol, CHECK_NULL);
   } else {
     // If "source:" tag is specified, all super class and super interfaces must be specified in the
     // class list file.
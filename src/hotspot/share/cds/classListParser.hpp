@@ -124,7 +124,7 @@ class ClassListParser : public StackObj {
   Klass* load_current_class(Symbol* class_name_symbol, TRAPS);
 
   size_t lineno() { return _input_stream.lineno(); }
-  FILE* do_open(const char* file);
+  static FILE* do_open(const char* file);
   ClassListParser(const char* file, ParseMode _parse_mode);
   ~ClassListParser();
 
@@ -134,6 +134,12 @@ class ClassListParser : public StackObj {
     return parser.parse(THREAD); // returns the number of classes loaded.
   }
 
+  // Loads and links the classes of the boot, platform and app loaders that are listed in
+  // classlist_path, using num_threads threads. This is done before the classlist is parsed
+  // by parse_classlist(), so that the serial parsing finds most classes already loaded.
+  // Classes of unregistered loaders, as well as the @ tags, are left to the parsing thread.
+  static void preload_in_parallel(const char* classlist_path, uint num_threads, TRAPS);
+
   static bool is_parsing_thread();
   static ClassListParser* instance() {
     assert(is_parsing_thread(), "call this only in the thread that created ClassListParsing::_instance");
@@ -184,6 +190,10 @@ class ClassListParser : public StackObj {
 
   bool is_loading_from_source();
 
+  // Load the named class via the system loader, which delegates to the boot, platform
+  // or app loader depending on the package name.
+  static Klass* load_builtin_class(Symbol* class_name_symbol, TRAPS);
+
   bool lambda_form_line() { return _lambda_form_line; }
 
   // Look up the super or interface of the current class being loaded
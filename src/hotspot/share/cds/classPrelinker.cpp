@@ -26,12 +26,19 @@
 #include "cds/archiveBuilder.hpp"
 #include "cds/cdsConfig.hpp"
 #include "cds/classPrelinker.hpp"
+#include "cds/cds_globals.hpp"
 #include "classfile/systemDictionary.hpp"
+#include "classfile/systemDictionaryShared.hpp"
 #include "classfile/vmClasses.hpp"
+#include "interpreter/bootstrapInfo.hpp"
+#include "interpreter/linkResolver.hpp"
+#include "logging/log.hpp"
 #include "memory/resourceArea.hpp"
 #include "oops/constantPool.inline.hpp"
+#include "oops/cpCache.inline.hpp"
 #include "oops/instanceKlass.hpp"
 #include "oops/klass.inline.hpp"
+#include "oops/resolvedIndyEntry.hpp"
 #include "runtime/handles.inline.hpp"
 
 ClassPrelinker::ClassesTable* ClassPrelinker::_processed_classes = nullptr;
@@ -140,6 +147,60 @@ void ClassPrelinker::dumptime_resolve_constants(InstanceKlass* ik, TRAPS) {
       break;
     }
   }
+
+  if (PrelinkLambdaCallSites && CDSConfig::is_dumping_static_archive()) {
+    maybe_resolve_lambda_call_sites(cp, CHECK);
+  }
+}
+
+// Link all the LambdaMetafactory call sites of the class, so that their lambda proxy
+// classes are generated and stored in the LambdaProxyClassDictionary, just as for the
+// call sites listed with @lambda-proxy in the classlist.
+//
+// The linked call sites themselves are not archived: their appendix MethodHandles
+// reference MemberNames and generated LambdaForm classes, which cannot be stored in
+// the archived heap (see JavaClasses::is_supported_for_archiving()). The ResolvedIndyEntries
+// are cleared by ResolvedIndyEntry::remove_unshareable_info(), and the call sites will
+// be linked again at runtime, but without generating any proxy classes.
+void ClassPrelinker::maybe_resolve_lambda_call_sites(constantPoolHandle cp, TRAPS) {
+  InstanceKlass* cp_holder = cp->pool_holder();
+  if (!cp_holder->is_shared_boot_class() &&
+      !cp_holder->is_shared_platform_class() &&
+      !cp_holder->is_shared_app_class()) {
+    // Lambda proxy classes are archived only for the built-in loaders.
+    return;
+  }
+
+  ConstantPoolCache* cpcache = cp->cache();
+  for (int indy_index = 0; indy_index < cpcache->resolved_indy_entries_length(); indy_index++) {
+    ResolvedIndyEntry* entry = cpcache->resolved_indy_entry_at(indy_index);
+    if (entry->is_resolved() || entry->resolution_failed()) {
+      continue;
+    }
+    int pool_index = entry->constant_pool_index();
+    BootstrapInfo bootstrap_specifier(cp, pool_index, indy_index);
+    bootstrap_specifier.resolve_bsm(THREAD);
+    if (!HAS_PENDING_EXCEPTION) {
+      if (!SystemDictionaryShared::is_supported_invokedynamic(&bootstrap_specifier)) {
+        continue;
+      }
+      CallInfo info;
+      Handle recv;
+      LinkResolver::resolve_invoke(info, recv, cp, indy_index, Bytecodes::_invokedynamic, THREAD);
+      if (!HAS_PENDING_EXCEPTION) {
+        cpcache->set_dynamic_call(info, indy_index);
+      }
+    }
+    if (HAS_PENDING_EXCEPTION) {
+      if (PENDING_EXCEPTION->is_a(vmClasses::OutOfMemoryError_klass())) {
+        return; // Let the caller report the OOM.
+      }
+      ResourceMark rm(THREAD);
+      log_debug(cds, lambda)("Cannot link call site at cp_index %d of %s: %s", pool_index,
+                             cp_holder->external_name(), PENDING_EXCEPTION->klass()->external_name());
+      CLEAR_PENDING_EXCEPTION;
+    }
+  }
 }
 
 Klass* ClassPrelinker::find_loaded_class(JavaThread* THREAD, oop class_loader, Symbol* name) {
@@ -67,6 +67,7 @@ class ClassPrelinker :  AllStatic {
   static Klass* maybe_resolve_class(constantPoolHandle cp, int cp_index, TRAPS);
   static bool can_archive_resolved_klass(InstanceKlass* cp_holder, Klass* resolved_klass);
   static Klass* find_loaded_class(JavaThread* THREAD, oop class_loader, Symbol* name);
+  static void maybe_resolve_lambda_call_sites(constantPoolHandle cp, TRAPS);
 
 public:
   static void initialize();
@@ -43,6 +43,7 @@
 #include "classfile/systemDictionaryShared.hpp"
 #include "classfile/vmClasses.hpp"
 #include "classfile/vmSymbols.hpp"
+#include "gc/shared/workerThread.hpp"
 #include "jvm.h"
 #include "logging/log.hpp"
 #include "logging/logMessage.hpp"
@@ -55,10 +56,12 @@
 #include "nmt/memTracker.hpp"
 #include "oops/compressedOops.hpp"
 #include "oops/compressedOops.inline.hpp"
+#include "oops/methodData.hpp"
 #include "oops/objArrayOop.hpp"
 #include "oops/oop.inline.hpp"
 #include "prims/jvmtiExport.hpp"
 #include "runtime/arguments.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/globals_extension.hpp"
 #include "runtime/java.hpp"
 #include "runtime/mutexLocker.hpp"
@@ -69,6 +72,7 @@
 #include "utilities/classpathStream.hpp"
 #include "utilities/defaultStream.hpp"
 #include "utilities/ostream.hpp"
+#include "utilities/zipLibrary.hpp"
 #if INCLUDE_G1GC
 #include "gc/g1/g1CollectedHeap.hpp"
 #include "gc/g1/g1HeapRegion.hpp"
@@ -215,6 +219,7 @@ void FileMapHeader::populate(FileMapInfo *info, size_t core_region_alignment,
   _max_heap_size = MaxHeapSize;
   _use_optimized_module_handling = CDSConfig::is_using_optimized_module_handling();
   _has_full_module_graph = CDSConfig::is_dumping_full_module_graph();
+  _method_profiles_fingerprint = CDSConfig::is_dumping_method_profiles() ? MethodData::layout_fingerprint() : 0;
 
   // The following fields are for sanity checks for whether this archive
   // will function correctly with this JVM and the bootclasspath it's
@@ -298,6 +303,7 @@ void FileMapHeader::print(outputStream* st) {
   st->print_cr("- allow_archiving_with_java_agent:%d", _allow_archiving_with_java_agent);
   st->print_cr("- use_optimized_module_handling:  %d", _use_optimized_module_handling);
   st->print_cr("- has_full_module_graph           %d", _has_full_module_graph);
+  st->print_cr("- method_profiles_fingerprint:    0x%08x", _method_profiles_fingerprint);
 }
 
 void SharedClassPathEntry::init_as_non_existent(const char* path, TRAPS) {
@@ -1346,7 +1352,7 @@ bool FileMapInfo::init_from_file(int fd) {
 
   for (int i = 0; i < MetaspaceShared::n_regions; i++) {
     FileMapRegion* r = region_at(i);
-    if (r->file_offset() > len || len - r->file_offset() < r->used()) {
+    if (r->file_offset() > len || len - r->file_offset() < r->file_size()) {
       log_warning(cds)("The shared archive file has been truncated.");
       return false;
     }
@@ -1444,6 +1450,7 @@ void FileMapRegion::init(int region_index, size_t mapping_offset, size_t size, b
   _crc = crc;
   _mapped_from_file = false;
   _mapped_base = nullptr;
+  _compressed_size = 0;
 }
 
 void FileMapRegion::init_oopmap(size_t offset, size_t size_in_bits) {
@@ -1456,6 +1463,103 @@ void FileMapRegion::init_ptrmap(size_t offset, size_t size_in_bits) {
   _ptrmap_size_in_bits = size_in_bits;
 }
 
+// Regions are read and checksummed in chunks of this size. When the GC has
+// safepoint workers, the chunks are processed in parallel. The CRC of a region is
+// combined from the CRCs of its chunks, so it is the same as ClassLoader::crc32()
+// of the whole region, and the archive format does not depend on the chunk size.
+static const size_t region_chunk_size = 4 * M;
+
+class FileMapRegionChunkTask : public WorkerTask {
+  char* const     _base;
+  const size_t    _size;        // number of bytes to read from _fd
+  const size_t    _crc_size;    // number of bytes to checksum, 0 if none
+  const int       _fd;          // -1 if the bytes are already in memory
+  const size_t    _file_offset;
+  const size_t    _num_chunks;
+  int* const      _chunk_crcs;
+  volatile size_t _next_chunk;
+  volatile bool   _failed;
+
+  static size_t chunk_size(size_t i, size_t limit) {
+    size_t offset = i * region_chunk_size;
+    return offset < limit ? MIN2(region_chunk_size, limit - offset) : 0;
+  }
+
+  bool read_chunk(char* addr, size_t count, size_t file_offset) {
+    while (count > 0) {
+      ssize_t n = os::read_at(_fd, addr, (unsigned int)count, (jlong)file_offset);
+      if (n <= 0) {
+        return false;
+      }
+      addr += n;
+      count -= n;
+      file_offset += n;
+    }
+    return true;
+  }
+
+public:
+  FileMapRegionChunkTask(char* base, size_t size, size_t crc_size, int fd, size_t file_offset) :
+    WorkerTask("CDS Region Chunks"),
+    _base(base),
+    _size(size),
+    _crc_size(crc_size),
+    _fd(fd),
+    _file_offset(file_offset),
+    _num_chunks(align_up(MAX2(size, crc_size), region_chunk_size) / region_chunk_size),
+    _chunk_crcs(NEW_C_HEAP_ARRAY(int, _num_chunks, mtClassShared)),
+    _next_chunk(0),
+    _failed(false) {
+    assert(fd >= 0 || size == 0, "nothing to read without a file");
+  }
+
+  ~FileMapRegionChunkTask() {
+    FREE_C_HEAP_ARRAY(int, _chunk_crcs);
+  }
+
+  void work(uint worker_id) {
+    while (!Atomic::load(&_failed)) {
+      size_t i = Atomic::fetch_then_add(&_next_chunk, (size_t)1);
+      if (i >= _num_chunks) {
+        return;
+      }
+      char* addr = _base + i * region_chunk_size;
+      size_t read_size = chunk_size(i, _size);
+      if (read_size > 0 && !read_chunk(addr, read_size, _file_offset + i * region_chunk_size)) {
+        Atomic::store(&_failed, true);
+        return;
+      }
+      size_t crc_size = chunk_size(i, _crc_size);
+      if (crc_size > 0) {
+        _chunk_crcs[i] = ClassLoader::crc32(0, addr, (jint)crc_size);
+      }
+    }
+  }
+
+  // Returns false if reading from the file has failed.
+  bool run() {
+    ArchiveUtils::run_chunked_task(this, _num_chunks);
+    return !_failed;
+  }
+
+  int crc() const {
+    int crc = 0;
+    for (size_t i = 0; i < _num_chunks; i++) {
+      size_t crc_size = chunk_size(i, _crc_size);
+      if (crc_size > 0) {
+        crc = ArchiveUtils::crc32_combine(crc, _chunk_crcs[i], crc_size);
+      }
+    }
+    return crc;
+  }
+};
+
+static int compute_region_crc(char* base, size_t size) {
+  FileMapRegionChunkTask task(base, 0, size, -1, 0);
+  task.run();
+  return task.crc();
+}
+
 bool FileMapRegion::check_region_crc(char* base) const {
   // This function should be called after the region has been properly
   // loaded into memory via FileMapInfo::map_region() or FileMapInfo::read_region().
@@ -1466,7 +1570,7 @@ bool FileMapRegion::check_region_crc(char* base) const {
   }
 
   assert(base != nullptr, "must be initialized");
-  int crc = ClassLoader::crc32(0, base, (jint)sz);
+  int crc = compute_region_crc(base, sz);
   if (crc != this->crc()) {
     log_warning(cds)("Checksum verification failed.");
     return false;
@@ -1521,6 +1625,7 @@ void FileMapRegion::print(outputStream* st, int region_index) {
   st->print_cr("- ptrmap_offset:                  " SIZE_FORMAT_X, _ptrmap_offset);
   st->print_cr("- ptrmap_size_in_bits:            " SIZE_FORMAT, _ptrmap_size_in_bits);
   st->print_cr("- mapped_base:                    " INTPTR_FORMAT, p2i(_mapped_base));
+  st->print_cr("- compressed_size:                " SIZE_FORMAT, _compressed_size);
 }
 
 void FileMapInfo::write_region(int region, char* base, size_t size,
@@ -1556,7 +1661,7 @@ void FileMapInfo::write_region(int region, char* base, size_t size,
   }
 
   r->set_file_offset(_file_offset);
-  int crc = ClassLoader::crc32(0, base, (jint)size);
+  int crc = compute_region_crc(base, size);
   if (size > 0) {
     log_info(cds)("Shared file region (%s) %d: " SIZE_FORMAT_W(8)
                    " bytes, addr " INTPTR_FORMAT " file offset 0x%08" PRIxPTR
@@ -1567,8 +1672,121 @@ void FileMapInfo::write_region(int region, char* base, size_t size,
   r->init(region, mapping_offset, size, read_only, allow_exec, crc);
 
   if (base != nullptr) {
-    write_bytes_aligned(base, size);
+    if (CompressSharedArchive && size > 0 &&
+        region != MetaspaceShared::bm && !HeapShared::is_heap_region(region)) {
+      write_compressed_region(r, base, size);
+    } else {
+      write_bytes_aligned(base, size);
+    }
+  }
+}
+
+// A compressed region is stored as a table with the compressed size of each of its
+// region_chunk_size chunks, followed by the chunks. The chunks are compressed
+// independently, so they can be compressed and decompressed in parallel.
+static const int region_compression_level = 1;
+
+void FileMapInfo::write_compressed_region(FileMapRegion* r, char* base, size_t size) {
+  const size_t num_chunks = align_up(size, region_chunk_size) / region_chunk_size;
+  size_t out_size;
+  size_t tmp_size;
+  const char* msg = ZipLibrary::init_params(region_chunk_size, &out_size, &tmp_size, region_compression_level);
+  if (msg != nullptr) {
+    MetaspaceShared::unrecoverable_writing_error(err_msg("Cannot compress shared archive: %s", msg));
+  }
+
+  char* out = NEW_C_HEAP_ARRAY(char, num_chunks * out_size, mtClassShared);
+  char* tmp = NEW_C_HEAP_ARRAY(char, num_chunks * tmp_size, mtClassShared);
+  size_t* chunk_sizes = NEW_C_HEAP_ARRAY(size_t, num_chunks, mtClassShared);
+
+  ArchiveUtils::parallel_for(num_chunks, 1, [&](size_t beg, size_t end) {
+    for (size_t i = beg; i < end; i++) {
+      size_t offset = i * region_chunk_size;
+      const char* chunk_msg = nullptr;
+      chunk_sizes[i] = ZipLibrary::compress(base + offset, MIN2(region_chunk_size, size - offset),
+                                            out + i * out_size, out_size, tmp + i * tmp_size, tmp_size,
+                                            region_compression_level, nullptr, &chunk_msg);
+      if (chunk_msg != nullptr) {
+        chunk_sizes[i] = 0;
+      }
+    }
+  });
+
+  align_file_position();
+  size_t file_offset = _file_offset;
+  write_bytes(chunk_sizes, num_chunks * sizeof(size_t));
+  for (size_t i = 0; i < num_chunks; i++) {
+    if (chunk_sizes[i] == 0) {
+      MetaspaceShared::unrecoverable_writing_error("Cannot compress shared archive");
+    }
+    write_bytes(out + i * out_size, chunk_sizes[i]);
+  }
+  r->set_compressed_size(_file_offset - file_offset);
+  align_file_position();
+
+  log_info(cds)("Compressed " SIZE_FORMAT " bytes into " SIZE_FORMAT " bytes in " SIZE_FORMAT " chunks",
+                size, r->compressed_size(), num_chunks);
+
+  FREE_C_HEAP_ARRAY(size_t, chunk_sizes);
+  FREE_C_HEAP_ARRAY(char, tmp);
+  FREE_C_HEAP_ARRAY(char, out);
+}
+
+bool FileMapInfo::read_compressed_region(FileMapRegion* r, char* base) {
+  const size_t size = r->used();
+  const size_t num_chunks = align_up(size, region_chunk_size) / region_chunk_size;
+  const size_t table_size = num_chunks * sizeof(size_t);
+  if (r->compressed_size() < table_size) {
+    log_warning(cds)("Compressed region is corrupt.");
+    return false;
+  }
+
+  char* in = NEW_C_HEAP_ARRAY(char, r->compressed_size(), mtClassShared);
+  FileMapRegionChunkTask read_task(in, r->compressed_size(), 0, _fd, r->file_offset());
+  if (!read_task.run()) {
+    FREE_C_HEAP_ARRAY(char, in);
+    // Close the file if there's a problem reading it.
+    close();
+    return false;
+  }
+
+  // Find the start of each compressed chunk.
+  const size_t* chunk_sizes = (const size_t*)in;
+  size_t* chunk_offsets = NEW_C_HEAP_ARRAY(size_t, num_chunks, mtClassShared);
+  size_t offset = table_size;
+  bool success = true;
+  for (size_t i = 0; i < num_chunks; i++) {
+    if (chunk_sizes[i] > r->compressed_size() - offset) {
+      success = false;
+      break;
+    }
+    chunk_offsets[i] = offset;
+    offset += chunk_sizes[i];
+  }
+
+  volatile bool failed = !success;
+  if (success) {
+    ArchiveUtils::parallel_for(num_chunks, 1, [&](size_t beg, size_t end) {
+      for (size_t i = beg; i < end; i++) {
+        size_t out_offset = i * region_chunk_size;
+        const char* msg = nullptr;
+        if (!ZipLibrary::decompress(in + chunk_offsets[i], chunk_sizes[i], base + out_offset,
+                                    MIN2(region_chunk_size, size - out_offset), &msg)) {
+          log_warning(cds)("Cannot decompress chunk " SIZE_FORMAT ": %s", i, msg != nullptr ? msg : "unknown error");
+          Atomic::store(&failed, true);
+        }
+      }
+    });
+  }
+
+  FREE_C_HEAP_ARRAY(size_t, chunk_offsets);
+  FREE_C_HEAP_ARRAY(char, in);
+
+  if (Atomic::load(&failed)) {
+    log_warning(cds)("Compressed region is corrupt.");
+    return false;
   }
+  return true;
 }
 
 static size_t write_bitmap(const CHeapBitMap* map, char* output, size_t offset) {
@@ -1806,13 +2024,26 @@ bool FileMapInfo::read_region(int i, char* base, size_t size, bool do_commit) {
       return false;
     }
   }
-  if (os::lseek(_fd, (long)r->file_offset(), SEEK_SET) != (int)r->file_offset() ||
-      read_bytes(base, size) != size) {
-    return false;
-  }
+  if (r->compressed()) {
+    if (!read_compressed_region(r, base)) {
+      return false;
+    }
+    if (VerifySharedSpaces && !r->check_region_crc(base)) {
+      return false;
+    }
+  } else {
+    // Read the region and, with VerifySharedSpaces, compute its CRC in the same pass.
+    FileMapRegionChunkTask task(base, size, VerifySharedSpaces ? r->used() : 0, _fd, r->file_offset());
+    if (!task.run()) {
+      // Close the file if there's a problem reading it.
+      close();
+      return false;
+    }
 
-  if (VerifySharedSpaces && !r->check_region_crc(base)) {
-    return false;
+    if (VerifySharedSpaces && task.crc() != r->crc()) {
+      log_warning(cds)("Checksum verification failed.");
+      return false;
+    }
   }
 
   r->set_mapped_from_file(false);
@@ -1841,13 +2072,23 @@ MapArchiveResult FileMapInfo::map_region(int i, intx addr_delta, char* mapped_ba
     r->set_read_only(false);
   } else if (addr_delta != 0) {
     r->set_read_only(false); // Need to patch the pointers
+  } else if (r->compressed()) {
+    r->set_read_only(false); // Decompressed into committed read-write memory
+  }
+
+  if (r->compressed() && !rs.is_reserved()) {
+    // A compressed region must be decompressed into committed memory. This can only happen
+    // on Windows, on the first attempt to map the archive(s), so report a mapping failure to
+    // have the archive(s) mapped again into a ReservedSpace.
+    log_info(cds)("Unable to read compressed %s shared space without reserved space", shared_region_name[i]);
+    return MAP_ARCHIVE_MMAP_FAILURE;
   }
 
-  if (MetaspaceShared::use_windows_memory_mapping() && rs.is_reserved()) {
+  if (r->compressed() || (MetaspaceShared::use_windows_memory_mapping() && rs.is_reserved())) {
     // This is the second time we try to map the archive(s). We have already created a ReservedSpace
     // that covers all the FileMapRegions to ensure all regions can be mapped. However, Windows
     // can't mmap into a ReservedSpace, so we just ::read() the data. We're going to patch all the
-    // regions anyway, so there's no benefit for mmap anyway.
+    // regions anyway, so there's no benefit for mmap anyway. Compressed regions are always read.
     if (!read_region(i, requested_addr, size, /* do_commit = */ true)) {
       log_info(cds)("Failed to read %s shared space into reserved space at " INTPTR_FORMAT,
                     shared_region_name[i], p2i(requested_addr));
@@ -1889,6 +2130,7 @@ char* FileMapInfo::map_bitmap_region() {
   }
   bool read_only = true, allow_exec = false;
   char* requested_addr = nullptr; // allow OS to pick any location
+  assert(!r->compressed(), "bitmap region is never compressed");
   char* bitmap_base = map_memory(_fd, _full_path, r->file_offset(),
                                  requested_addr, r->used_aligned(), read_only, allow_exec, mtClassShared);
   if (bitmap_base == nullptr) {
@@ -1913,6 +2155,64 @@ char* FileMapInfo::map_bitmap_region() {
   return bitmap_base;
 }
 
+// Patches the pointers marked in the ptrmaps of the rw and ro regions. Each ptrmap is
+// split into chunks that are patched independently, so that the relocation can use
+// the GC's safepoint workers. This only shortens the time spent relocating at startup:
+// every pointer is still patched eagerly, so all pages of the rw and ro regions that
+// contain pointers are dirtied and no longer shared with other processes. The
+// SharedDataRelocators have no mutable state and are shared by all workers.
+class CoreRegionsRelocationTask : public WorkerTask {
+  // On 64-bit, each chunk covers 512KB of the region.
+  static const BitMap::idx_t bits_per_chunk = 64 * K;
+
+  const BitMapView*    _rw_ptrmap;
+  SharedDataRelocator* _rw_patcher;
+  const BitMapView*    _ro_ptrmap;
+  SharedDataRelocator* _ro_patcher;
+  const size_t         _rw_chunks;
+  const size_t         _ro_chunks;
+  volatile size_t      _next_chunk;
+
+  static size_t num_chunks(const BitMapView* ptrmap) {
+    return align_up(ptrmap->size(), bits_per_chunk) / bits_per_chunk;
+  }
+
+  static void patch_chunk(const BitMapView* ptrmap, SharedDataRelocator* patcher, size_t chunk) {
+    BitMap::idx_t beg = chunk * bits_per_chunk;
+    BitMap::idx_t end = MIN2(beg + bits_per_chunk, ptrmap->size());
+    ptrmap->iterate(patcher, beg, end);
+  }
+
+public:
+  CoreRegionsRelocationTask(const BitMapView* rw_ptrmap, SharedDataRelocator* rw_patcher,
+                            const BitMapView* ro_ptrmap, SharedDataRelocator* ro_patcher) :
+    WorkerTask("CDS Relocation"),
+    _rw_ptrmap(rw_ptrmap),
+    _rw_patcher(rw_patcher),
+    _ro_ptrmap(ro_ptrmap),
+    _ro_patcher(ro_patcher),
+    _rw_chunks(num_chunks(rw_ptrmap)),
+    _ro_chunks(num_chunks(ro_ptrmap)),
+    _next_chunk(0) {}
+
+  void work(uint worker_id) {
+    while (true) {
+      size_t i = Atomic::fetch_then_add(&_next_chunk, (size_t)1);
+      if (i < _rw_chunks) {
+        patch_chunk(_rw_ptrmap, _rw_patcher, i);
+      } else if (i < _rw_chunks + _ro_chunks) {
+        patch_chunk(_ro_ptrmap, _ro_patcher, i - _rw_chunks);
+      } else {
+        return;
+      }
+    }
+  }
+
+  void run() {
+    ArchiveUtils::run_chunked_task(this, _rw_chunks + _ro_chunks);
+  }
+};
+
 // This is called when we cannot map the archive at the requested[ base address (usually 0x800000000).
 // We relocate all pointers in the 2 core regions (ro, rw).
 bool FileMapInfo::relocate_pointers_in_core_regions(intx addr_delta) {
@@ -1951,8 +2251,8 @@ bool FileMapInfo::relocate_pointers_in_core_regions(intx addr_delta) {
                                 valid_new_base, valid_new_end, addr_delta);
     SharedDataRelocator ro_patcher((address*)ro_patch_base + header()->ro_ptrmap_start_pos(), (address*)ro_patch_end, valid_old_base, valid_old_end,
                                 valid_new_base, valid_new_end, addr_delta);
-    rw_ptrmap.iterate(&rw_patcher);
-    ro_ptrmap.iterate(&ro_patcher);
+    CoreRegionsRelocationTask task(&rw_ptrmap, &rw_patcher, &ro_ptrmap, &ro_patcher);
+    task.run();
 
     // The MetaspaceShared::bm region will be unmapped in MetaspaceShared::initialize_shared_spaces().
 
@@ -2020,12 +2320,7 @@ void FileMapInfo::map_or_load_heap_region() {
     } else if (ArchiveHeapLoader::can_load()) {
       success = ArchiveHeapLoader::load_heap_region(this);
     } else {
-      if (!UseCompressedOops && !ArchiveHeapLoader::can_map()) {
-        // TODO - remove implicit knowledge of G1
-        log_info(cds)("Cannot use CDS heap data. UseG1GC is required for -XX:-UseCompressedOops");
-      } else {
-        log_info(cds)("Cannot use CDS heap data. UseEpsilonGC, UseG1GC, UseSerialGC or UseParallelGC are required.");
-      }
+      log_info(cds)("Cannot use CDS heap data. UseEpsilonGC, UseG1GC, UseSerialGC, UseParallelGC, UseShenandoahGC or UseZGC are required.");
     }
   }
 
@@ -2092,7 +2387,9 @@ address FileMapInfo::heap_region_dumptime_address() {
   if (UseCompressedOops) {
     return /*dumptime*/ narrow_oop_base() + r->mapping_offset();
   } else {
-    return heap_region_requested_address();
+    // With uncompressed oops, the objects are always written as if the heap started at
+    // this address. See ArchiveHeapWriter::set_requested_address().
+    return (address)ArchiveHeapWriter::NOCOOPS_REQUESTED_BASE;
   }
 }
 
@@ -2460,6 +2757,13 @@ bool FileMapHeader::validate() {
     CDSConfig::stop_using_full_module_graph("archive was created without full module graph");
   }
 
+  if (_method_profiles_fingerprint != 0 && _method_profiles_fingerprint != MethodData::layout_fingerprint()) {
+    // The archived MethodData have a different layout than what this JVM would create. Don't use them.
+    log_info(cds)("Archived method profiles are disabled because the profiling flags are different "
+                  "from those used when the archive was created");
+    _method_profiles_fingerprint = 0;
+  }
+
   return true;
 }
 
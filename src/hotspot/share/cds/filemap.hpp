@@ -159,11 +159,15 @@ class FileMapRegion: private CDSFileMapRegion {
   size_t oopmap_size_in_bits()      const { assert_is_heap_region();     return _oopmap_size_in_bits; }
   size_t ptrmap_offset()            const { return _ptrmap_offset; }
   size_t ptrmap_size_in_bits()      const { return _ptrmap_size_in_bits; }
+  bool   compressed()               const { return _compressed_size != 0; }
+  size_t compressed_size()          const { return _compressed_size; }
+  size_t file_size()                const { return compressed() ? _compressed_size : _used; }
 
   void set_file_offset(size_t s)     { _file_offset = s; }
   void set_read_only(bool v)         { _read_only = v; }
   void set_mapped_base(char* p)      { _mapped_base = p; }
   void set_mapped_from_file(bool v)  { _mapped_from_file = v; }
+  void set_compressed_size(size_t s) { _compressed_size = s; }
   void init(int region_index, size_t mapping_offset, size_t size, bool read_only,
             bool allow_exec, int crc);
   void init_oopmap(size_t offset, size_t size_in_bits);
@@ -225,6 +229,8 @@ class FileMapHeader: private CDSFileMapHeaderBase {
   bool   _use_optimized_module_handling;// No module-relation VM options were specified, so we can skip
                                         // some expensive operations.
   bool   _has_full_module_graph;        // Does this CDS archive contain the full archived module graph?
+  unsigned int _method_profiles_fingerprint; // MethodData::layout_fingerprint() if the archive contains
+                                        // MethodData and MethodCounters, or 0.
   size_t _heap_roots_offset;            // Offset of the HeapShared::roots() object, from the bottom
                                         // of the archived heap objects, in bytes.
   size_t _heap_oopmap_start_pos;        // The first bit in the oopmap corresponds to this position in the heap.
@@ -270,6 +276,7 @@ class FileMapHeader: private CDSFileMapHeaderBase {
   bool has_non_jar_in_classpath()          const { return _has_non_jar_in_classpath; }
   bool compressed_oops()                   const { return _compressed_oops; }
   bool compressed_class_pointers()         const { return _compressed_class_ptrs; }
+  bool has_method_profiles()               const { return _method_profiles_fingerprint != 0; }
   size_t heap_roots_offset()               const { return _heap_roots_offset; }
   size_t heap_oopmap_start_pos()           const { return _heap_oopmap_start_pos; }
   size_t heap_ptrmap_start_pos()           const { return _heap_ptrmap_start_pos; }
@@ -451,6 +458,7 @@ class FileMapInfo : public CHeapObj<mtInternal> {
   size_t write_heap_region(ArchiveHeapInfo* heap_info);
   void  write_bytes(const void* buffer, size_t count);
   void  write_bytes_aligned(const void* buffer, size_t count);
+  void  write_compressed_region(FileMapRegion* r, char* base, size_t size);
   size_t  read_bytes(void* buffer, size_t count);
   static size_t readonly_total();
   MapArchiveResult map_regions(int regions[], int num_regions, char* mapped_base_address, ReservedSpace rs);
@@ -461,6 +469,7 @@ class FileMapInfo : public CHeapObj<mtInternal> {
   bool  has_heap_region()  NOT_CDS_JAVA_HEAP_RETURN_(false);
   MemRegion get_heap_region_requested_range() NOT_CDS_JAVA_HEAP_RETURN_(MemRegion());
   bool  read_region(int i, char* base, size_t size, bool do_commit);
+  bool  read_compressed_region(FileMapRegion* r, char* base);
   char* map_bitmap_region();
   void  unmap_region(int i);
   void  close();
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2024, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "cds/cds_globals.hpp"
+#include "cds/hotClassProfile.hpp"
+#include "classfile/symbolTable.hpp"
+#include "logging/log.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/instanceKlass.hpp"
+#include "oops/symbol.hpp"
+#include "runtime/java.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "utilities/istream.hpp"
+#include "utilities/ostream.hpp"
+#include "utilities/resourceHash.hpp"
+
+class HotClassProfile::RankTable : public ResourceHashtable<
+  Symbol*, int,
+  15889, // prime number
+  AnyObj::C_HEAP, mtClassShared> {};
+
+fileStream* HotClassProfile::_profile_file = nullptr;
+HotClassProfile::RankTable* HotClassProfile::_ranks = nullptr;
+int HotClassProfile::_num_recorded = 0;
+
+void HotClassProfile::init() {
+  // For -XX:DumpArchiveLayoutProfile=<file> option
+  if (DumpArchiveLayoutProfile != nullptr) {
+    const char* profile_name = make_log_name(DumpArchiveLayoutProfile, nullptr);
+    _profile_file = new (mtClassShared) fileStream(profile_name);
+    if (!_profile_file->is_open()) {
+      log_warning(cds)("Cannot open %s for writing the archive layout profile", profile_name);
+      delete _profile_file;
+      _profile_file = nullptr;
+    } else {
+      _profile_file->print_cr("# NOTE: Do not modify this file.");
+      _profile_file->print_cr("#");
+      _profile_file->print_cr("# This file is generated via the -XX:DumpArchiveLayoutProfile=<file> option");
+      _profile_file->print_cr("# and is used at CDS archive dump time (see -XX:ArchiveLayoutProfile).");
+      _profile_file->print_cr("#");
+    }
+    FREE_C_HEAP_ARRAY(char, profile_name);
+  }
+}
+
+void HotClassProfile::record_initialized(const InstanceKlass* ik) {
+  if (!is_recording() || ik->is_hidden()) {
+    // Hidden classes do not have stable names, so they can't be matched at dump time.
+    return;
+  }
+  ResourceMark rm;
+  MutexLocker ml(HotClassProfile_lock, Mutex::_no_safepoint_check_flag);
+  write(ik);
+}
+
+void HotClassProfile::write(const InstanceKlass* ik) {
+  assert_lock_strong(HotClassProfile_lock);
+  if (_profile_file != nullptr) {
+    _profile_file->print_cr("%s", ik->name()->as_C_string());
+    _num_recorded++;
+  }
+}
+
+void HotClassProfile::close() {
+  if (_profile_file != nullptr) {
+    MutexLocker ml(HotClassProfile_lock, Mutex::_no_safepoint_check_flag);
+    log_info(cds)("Recorded %d initialized classes in the archive layout profile", _num_recorded);
+    delete _profile_file;
+    _profile_file = nullptr;
+  }
+}
+
+void HotClassProfile::load() {
+  if (ArchiveLayoutProfile == nullptr || is_loaded()) {
+    return;
+  }
+
+  FileInput file_input(ArchiveLayoutProfile);
+  if (!file_input.is_open()) {
+    log_warning(cds)("Cannot open archive layout profile %s; classes will be laid out by name", ArchiveLayoutProfile);
+    return;
+  }
+
+  _ranks = new (mtClassShared) RankTable();
+  int num_lines = 0;
+  inputStream input(&file_input);
+  for (; !input.done(); input.next()) {
+    char* line = input.current_line();
+    size_t len = input.current_line_length();
+    while (len > 0 && (line[len - 1] == ' ' || line[len - 1] == '\t' || line[len - 1] == '\r')) {
+      len--;
+    }
+    if (len == 0 || *line == '#' || len > Symbol::max_length()) {
+      continue;
+    }
+    num_lines++;
+    // Classes that have not been loaded at dump time can't be archived, so there's
+    // no need to create symbols for their names.
+    Symbol* name = SymbolTable::probe(line, (int)len);
+    if (name != nullptr) {
+      bool created;
+      _ranks->put_if_absent(name, _ranks->number_of_entries(), &created);
+      if (!created) {
+        // The same class name may be listed more than once if it was initialized
+        // by several loaders; keep the earliest rank.
+        name->decrement_refcount();
+      }
+    }
+  }
+  log_info(cds)("Loaded archive layout profile %s: %d classes, %d known", ArchiveLayoutProfile,
+                num_lines, _ranks->number_of_entries());
+}
+
+void HotClassProfile::unload() {
+  if (_ranks != nullptr) {
+    _ranks->iterate_all([&](Symbol* name, int rank) {
+      name->decrement_refcount();
+    });
+    delete _ranks;
+    _ranks = nullptr;
+  }
+}
+
+int HotClassProfile::rank_of(Klass* k) {
+  if (_ranks == nullptr || !k->is_instance_klass()) {
+    return -1;
+  }
+  int* rank = _ranks->get(k->name());
+  return (rank == nullptr) ? -1 : *rank;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2024, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_CDS_HOTCLASSPROFILE_HPP
+#define SHARE_CDS_HOTCLASSPROFILE_HPP
+
+#include "memory/allStatic.hpp"
+#include "utilities/macros.hpp"
+
+class fileStream;
+class InstanceKlass;
+class Klass;
+
+// A hot class profile lists the classes that were initialized during a training
+// run, in the order of their initialization. It is written with
+// -XX:DumpArchiveLayoutProfile=<file> and read back at dump time with
+// -XX:ArchiveLayoutProfile=<file>. ArchiveBuilder uses it to copy the metadata
+// of the hot classes ahead of everything else, so that the pages touched during
+// start-up are packed together at the beginning of the rw and ro regions.
+class HotClassProfile : AllStatic {
+#if INCLUDE_CDS
+  class RankTable;
+  static fileStream* _profile_file;
+  static RankTable* _ranks;
+  static int _num_recorded;
+
+  static void write(const InstanceKlass* ik);
+public:
+  static bool is_recording() {
+    return _profile_file != nullptr;
+  }
+  static bool is_loaded() {
+    return _ranks != nullptr;
+  }
+#else
+public:
+  static bool is_recording() { return false; }
+  static bool is_loaded()    { return false; }
+#endif // INCLUDE_CDS
+
+  // Training run
+  static void init() NOT_CDS_RETURN;
+  static void record_initialized(const InstanceKlass* ik) NOT_CDS_RETURN;
+  static void close() NOT_CDS_RETURN;
+
+  // Dump time
+  static void load() NOT_CDS_RETURN;
+  static void unload() NOT_CDS_RETURN;
+  // Returns the position of k in the profile, or -1 if k is not hot.
+  static int rank_of(Klass* k) NOT_CDS_RETURN_(-1);
+  static bool is_hot(Klass* k) { return rank_of(k) >= 0; }
+};
+
+#endif // SHARE_CDS_HOTCLASSPROFILE_HPP
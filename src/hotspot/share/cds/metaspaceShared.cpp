@@ -396,6 +396,7 @@ void MetaspaceShared::serialize(SerializeClosure* soc) {
   CDS_JAVA_HEAP_ONLY(ClassLoaderDataShared::serialize(soc);)
 
   LambdaFormInvokers::serialize(soc);
+  AdapterHandlerLibrary::serialize_shared_table_header(soc);
   soc->do_tag(666);
 }
 
@@ -485,6 +486,7 @@ char* VM_PopulateDumpSharedSpace::dump_read_only_tables() {
 
   // Write lambform lines into archive
   LambdaFormInvokers::dump_static_archive_invokers();
+  AdapterHandlerLibrary::archive_adapter_fingerprints();
   // Write module name into archive
   CDS_JAVA_HEAP_ONLY(Modules::dump_main_module_name();)
   // Write the other data to the output array.
@@ -737,6 +739,12 @@ void MetaspaceShared::preload_classes(TRAPS) {
   }
 
   log_info(cds)("Loading classes to share ...");
+  if (ClassListPreloadThreads > 0) {
+    ClassListParser::preload_in_parallel(classlist_path, ClassListPreloadThreads, CHECK);
+    if (ExtraSharedClassListFile) {
+      ClassListParser::preload_in_parallel(ExtraSharedClassListFile, ClassListPreloadThreads, CHECK);
+    }
+  }
   int class_count = ClassListParser::parse_classlist(classlist_path,
                                                      ClassListParser::_parse_all, CHECK);
   if (ExtraSharedClassListFile) {
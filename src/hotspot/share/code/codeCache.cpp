@@ -174,6 +174,7 @@ ExceptionCache* volatile CodeCache::_exception_cache_purge_list = nullptr;
 GrowableArray<CodeHeap*>* CodeCache::_heaps = new(mtCode) GrowableArray<CodeHeap*> (static_cast<int>(CodeBlobType::All), mtCode);
 GrowableArray<CodeHeap*>* CodeCache::_nmethod_heaps = new(mtCode) GrowableArray<CodeHeap*> (static_cast<int>(CodeBlobType::All), mtCode);
 GrowableArray<CodeHeap*>* CodeCache::_allocable_heaps = new(mtCode) GrowableArray<CodeHeap*> (static_cast<int>(CodeBlobType::All), mtCode);
+CodeHeap* CodeCache::_hot_heap = nullptr;
 
 static void check_min_size(const char* codeheap, size_t size, size_t required_size) {
   if (size < required_size) {
@@ -308,6 +309,21 @@ void CodeCache::initialize_heaps() {
   profiled.size = align_down(profiled.size, min_size);
   non_profiled.size = align_down(non_profiled.size, min_size);
 
+  // The hot code heap is carved out of the non-profiled one. It is aligned
+  // like the other heaps so that it is backed by whole large pages if the
+  // code cache uses them.
+  size_t hot_size = align_up(HotCodeHeapSize, min_size);
+  if (hot_size > 0) {
+    if (non_profiled.enabled && non_profiled.size >= hot_size + min_size) {
+      non_profiled.size -= hot_size;
+    } else {
+      log_warning(codecache)("HotCodeHeapSize (" SIZE_FORMAT "K) does not fit into the non-profiled code heap (" SIZE_FORMAT "K). "
+                             "Hot code heap is disabled.", hot_size/K, non_profiled.size/K);
+      hot_size = 0;
+    }
+  }
+
+  FLAG_SET_ERGO(HotCodeHeapSize, hot_size);
   FLAG_SET_ERGO(NonNMethodCodeHeapSize, non_nmethod.size);
   FLAG_SET_ERGO(ProfiledCodeHeapSize, profiled.size);
   FLAG_SET_ERGO(NonProfiledCodeHeapSize, non_profiled.size);
@@ -331,6 +347,14 @@ void CodeCache::initialize_heaps() {
   // Non-nmethods (stubs, adapters, ...)
   add_heap(non_method_space, "CodeHeap 'non-nmethods'", CodeBlobType::NonNMethod);
 
+  if (hot_size > 0) {
+    ReservedSpace hot_space = rs.partition(offset, hot_size);
+    offset += hot_size;
+    // Tier 4 nmethods of methods that were hot when they were compiled, placed
+    // next to the stubs they call and away from cold code.
+    _hot_heap = add_heap(hot_space, "CodeHeap 'hot nmethods'", CodeBlobType::MethodNonProfiled);
+  }
+
   if (non_profiled.enabled) {
     ReservedSpace non_profiled_space  = rs.partition(offset, non_profiled.size);
     // Tier 1 and tier 4 (non-profiled) methods and native methods
@@ -416,10 +440,10 @@ void CodeCache::add_heap(CodeHeap* heap) {
   }
 }
 
-void CodeCache::add_heap(ReservedSpace rs, const char* name, CodeBlobType code_blob_type) {
+CodeHeap* CodeCache::add_heap(ReservedSpace rs, const char* name, CodeBlobType code_blob_type) {
   // Check if heap is needed
   if (!heap_available(code_blob_type)) {
-    return;
+    return nullptr;
   }
 
   // Create CodeHeap
@@ -436,6 +460,7 @@ void CodeCache::add_heap(ReservedSpace rs, const char* name, CodeBlobType code_b
 
   // Register the CodeHeap
   MemoryService::add_code_heap_memory_pool(heap, name);
+  return heap;
 }
 
 CodeHeap* CodeCache::get_code_heap_containing(void* start) {
@@ -460,7 +485,8 @@ CodeHeap* CodeCache::get_code_heap(const void* cb) {
 
 CodeHeap* CodeCache::get_code_heap(CodeBlobType code_blob_type) {
   FOR_ALL_HEAPS(heap) {
-    if ((*heap)->accepts(code_blob_type)) {
+    // The hot code heap is only allocated from explicitly, see allocate_hot().
+    if ((*heap)->accepts(code_blob_type) && *heap != _hot_heap) {
       return *heap;
     }
   }
@@ -567,6 +593,39 @@ CodeBlob* CodeCache::allocate(uint size, CodeBlobType code_blob_type, bool handl
   return cb;
 }
 
+// Allocate in the hot code heap. Unlike allocate(), this neither falls back
+// to other code heaps nor reports a full code cache: the caller allocates
+// in the regular heap for its code blob type instead.
+CodeBlob* CodeCache::allocate_hot(uint size) {
+  assert_locked_or_safepoint(CodeCache_lock);
+  if (_hot_heap == nullptr || size == 0) {
+    return nullptr;
+  }
+  CodeBlob* cb = (CodeBlob*)_hot_heap->allocate(size);
+  while (cb == nullptr && _hot_heap->expand_by(CodeCacheExpansionSize)) {
+    OrderAccess::release(); // ensure heap expansion is visible to an asynchronous observer (e.g. CodeHeapPool::get_memory_usage())
+    cb = (CodeBlob*)_hot_heap->allocate(size);
+  }
+  if (cb != nullptr) {
+    print_trace("allocation", cb, size);
+  }
+  return cb;
+}
+
+// Hot code is tier 4 code of methods that were trained to tier 4 in the run
+// that dumped the CDS archive, or that had a high event rate when the
+// compilation was selected from the compile queue.
+bool CodeCache::is_hot_candidate(const Method* method, int comp_level) {
+  return _hot_heap != nullptr && is_hot_method(method, comp_level);
+}
+
+bool CodeCache::is_hot_method(const Method* method, int comp_level) {
+  if (comp_level != CompLevel_full_optimization) {
+    return false;
+  }
+  return method->has_trained_code() || method->rate() >= (float)HotCodeMinRate;
+}
+
 void CodeCache::free(CodeBlob* cb) {
   assert_locked_or_safepoint(CodeCache_lock);
   CodeHeap* heap = get_code_heap(cb);
@@ -768,12 +827,76 @@ uint64_t CodeCache::cold_gc_count() {
   return _cold_gc_count;
 }
 
+// Called with the result of the is_unloading() computation of an nmethod
+// that was found to be unloading, once per nmethod.
+void CodeCache::record_unloading(nmethod* nm, bool is_cold) {
+  Atomic::inc(&_unloaded_count);
+  Atomic::add(&_unloaded_size, (size_t)nm->size());
+  if (is_cold) {
+    Atomic::inc(&_unloaded_cold_count);
+    Atomic::add(&_unloaded_cold_size, (size_t)nm->size());
+  }
+}
+
+// Report the nmethods unloaded since the previous marking cycle finished.
+void CodeCache::report_unloading() {
+  uint count = Atomic::xchg(&_unloaded_count, 0u);
+  size_t size = Atomic::xchg(&_unloaded_size, (size_t)0);
+  uint cold_count = Atomic::xchg(&_unloaded_cold_count, 0u);
+  size_t cold_size = Atomic::xchg(&_unloaded_cold_size, (size_t)0);
+  _total_unloaded_count += count;
+  _total_unloaded_size += size;
+  _total_unloaded_cold_count += cold_count;
+  _total_unloaded_cold_size += cold_size;
+
+  if (count > 0) {
+    log_info(codecache)("Unloaded %u nmethods (" SIZE_FORMAT "K), %u of them cold (" SIZE_FORMAT "K)",
+                        count, size / K, cold_count, cold_size / K);
+  }
+
+  EventCodeCacheUnloading event;
+  if (event.should_commit()) {
+    event.set_unloadedCount(count);
+    event.set_unloadedSize(size);
+    event.set_coldCount(cold_count);
+    event.set_coldSize(cold_size);
+    event.set_coldGCCount(_cold_gc_count);
+    event.set_unallocatedCapacity(unallocated_capacity());
+    event.set_codeCacheMaxCapacity(max_capacity());
+    event.commit();
+  }
+}
+
+// Request a GC that unloads cold nmethods aggressively, like gc_on_allocation()
+// does when the code cache is almost full. This is called from code cache
+// allocation, where locks like Compile_lock may be held, so the GC itself is
+// left to the next gc_on_allocation().
+void CodeCache::request_aggressive_unloading() {
+  if (!Atomic::load(&_aggressive_unloading_requested)) {
+    Atomic::store(&_aggressive_unloading_requested, true);
+  }
+}
+
+bool CodeCache::aggressive_unloading_requested() {
+  return Atomic::load(&_aggressive_unloading_requested);
+}
+
 void CodeCache::gc_on_allocation() {
   if (!is_init_completed()) {
     // Let's not heuristically trigger GCs before the JVM is ready for GCs, no matter what
     return;
   }
 
+  if (Atomic::load(&_aggressive_unloading_requested)) {
+    // In case the GC is concurrent, we make sure only one thread requests the GC.
+    if (Atomic::cmpxchg(&_unloading_threshold_gc_requested, false, true) == false) {
+      Atomic::store(&_aggressive_unloading_requested, false);
+      log_info(codecache)("Triggering aggressive GC due to full code cache");
+      Universe::heap()->collect(GCCause::_codecache_GC_aggressive);
+    }
+    return;
+  }
+
   size_t free = unallocated_capacity();
   size_t max = max_capacity();
   size_t used = max - free;
@@ -827,6 +950,15 @@ uint64_t CodeCache::_cold_gc_count = INT_MAX;
 double CodeCache::_last_unloading_time = 0.0;
 size_t CodeCache::_last_unloading_used = 0;
 volatile bool CodeCache::_unloading_threshold_gc_requested = false;
+volatile bool CodeCache::_aggressive_unloading_requested = false;
+volatile uint CodeCache::_unloaded_count = 0;
+volatile size_t CodeCache::_unloaded_size = 0;
+volatile uint CodeCache::_unloaded_cold_count = 0;
+volatile size_t CodeCache::_unloaded_cold_size = 0;
+uint CodeCache::_total_unloaded_count = 0;
+size_t CodeCache::_total_unloaded_size = 0;
+uint CodeCache::_total_unloaded_cold_count = 0;
+size_t CodeCache::_total_unloaded_cold_size = 0;
 TruncatedSeq CodeCache::_unloading_gc_intervals(10 /* samples */);
 TruncatedSeq CodeCache::_unloading_allocation_rates(10 /* samples */);
 
@@ -858,6 +990,7 @@ void CodeCache::on_gc_marking_cycle_start() {
 void CodeCache::on_gc_marking_cycle_finish() {
   assert(is_gc_marking_cycle_active(), "Marking cycle started before last one finished");
   ++_gc_epoch;
+  report_unloading();
   update_cold_gc_count();
 }
 
@@ -1118,6 +1251,10 @@ void CodeCache::initialize() {
     initialize_heaps();
   } else {
     // Use a single code heap
+    if (HotCodeHeapSize > 0) {
+      log_warning(codecache)("HotCodeHeapSize requires SegmentedCodeCache. Hot code heap is disabled.");
+      FLAG_SET_ERGO(HotCodeHeapSize, 0);
+    }
     FLAG_SET_ERGO(NonNMethodCodeHeapSize, (uintx)os::vm_page_size());
     FLAG_SET_ERGO(ProfiledCodeHeapSize, 0);
     FLAG_SET_ERGO(NonProfiledCodeHeapSize, 0);
@@ -1415,11 +1552,13 @@ void CodeCache::report_codemem_full(CodeBlobType code_blob_type, bool print) {
 
   if ((full_count == 1) || print) {
     // Not yet reported for this heap, report
+    const char* consequence = (UseCodeCacheFlushing && HotnessBasedCodeCacheFlushing) ?
+                              "Unloading cold code." : "Compiler has been disabled.";
     if (SegmentedCodeCache) {
       ResourceMark rm;
       stringStream msg1_stream, msg2_stream;
-      msg1_stream.print("%s is full. Compiler has been disabled.",
-                        get_code_heap_name(code_blob_type));
+      msg1_stream.print("%s is full. %s",
+                        get_code_heap_name(code_blob_type), consequence);
       msg2_stream.print("Try increasing the code heap size using -XX:%s=",
                  get_code_heap_flag_name(code_blob_type));
       const char *msg1 = msg1_stream.as_string();
@@ -1430,7 +1569,10 @@ void CodeCache::report_codemem_full(CodeBlobType code_blob_type, bool print) {
       warning("%s", msg1);
       warning("%s", msg2);
     } else {
-      const char *msg1 = "CodeCache is full. Compiler has been disabled.";
+      ResourceMark rm;
+      stringStream msg1_stream;
+      msg1_stream.print("CodeCache is full. %s", consequence);
+      const char *msg1 = msg1_stream.as_string();
       const char *msg2 = "Try increasing the code cache size using -XX:ReservedCodeCacheSize=";
 
       log_warning(codecache)("%s", msg1);
@@ -1751,6 +1893,11 @@ void CodeCache::print_summary(outputStream* st, bool detailed) {
                  "disabled (not enough contiguous free space left)",
                  CompileBroker::get_total_compiler_stopped_count(),
                  CompileBroker::get_total_compiler_restarted_count());
+    st->print_cr("Unloading: nmethods=" UINT32_FORMAT " (" SIZE_FORMAT "Kb), cold=" UINT32_FORMAT " (" SIZE_FORMAT "Kb)"
+                 ", cold_gc_count=" UINT64_FORMAT,
+                 _total_unloaded_count, _total_unloaded_size / K,
+                 _total_unloaded_cold_count, _total_unloaded_cold_size / K,
+                 _cold_gc_count);
   }
 }
 
@@ -53,6 +53,12 @@
 // In the rare case of the non-nmethod code heap getting full, non-nmethod code
 // will be stored in the non-profiled code heap as a fallback solution.
 //
+// If HotCodeHeapSize is set, a second heap for non-profiled nmethods is
+// carved out of the non-profiled one and placed next to the non-nmethod heap.
+// It only receives level 4 code of methods that are hot when compiled (see
+// CodeCache::is_hot_candidate(..)), which keeps hot code dense in the iTLB
+// and instruction cache. Lookups by CodeBlobType never return this heap.
+//
 // Depending on the availability of compilers and compilation mode there
 // may be fewer heaps. The size of the code heaps depends on the values of
 // ReservedCodeCacheSize, NonProfiledCodeHeapSize and ProfiledCodeHeapSize
@@ -92,6 +98,7 @@ class CodeCache : AllStatic {
   static GrowableArray<CodeHeap*>* _heaps;
   static GrowableArray<CodeHeap*>* _nmethod_heaps;
   static GrowableArray<CodeHeap*>* _allocable_heaps;
+  static CodeHeap*                 _hot_heap;   // Hot non-profiled nmethods, see HotCodeHeapSize
 
   static address _low_bound;                                 // Lower bound of CodeHeap addresses
   static address _high_bound;                                // Upper bound of CodeHeap addresses
@@ -105,6 +112,20 @@ class CodeCache : AllStatic {
   static TruncatedSeq      _unloading_gc_intervals;
   static TruncatedSeq      _unloading_allocation_rates;
   static volatile bool     _unloading_threshold_gc_requested;
+  static volatile bool     _aggressive_unloading_requested; // see request_aggressive_unloading()
+
+  // nmethods unloaded since the last GC marking cycle finished, see report_unloading()
+  static volatile uint     _unloaded_count;
+  static volatile size_t   _unloaded_size;
+  static volatile uint     _unloaded_cold_count;
+  static volatile size_t   _unloaded_cold_size;
+  // Totals over the lifetime of the VM
+  static uint              _total_unloaded_count;
+  static size_t            _total_unloaded_size;
+  static uint              _total_unloaded_cold_count;
+  static size_t            _total_unloaded_cold_size;
+
+  static void report_unloading();
 
   static ExceptionCache* volatile _exception_cache_purge_list;
 
@@ -112,7 +133,7 @@ class CodeCache : AllStatic {
   static void initialize_heaps();                             // Initializes the CodeHeaps
 
   // Creates a new heap with the given name and size, containing CodeBlobs of the given type
-  static void add_heap(ReservedSpace rs, const char* name, CodeBlobType code_blob_type);
+  static CodeHeap* add_heap(ReservedSpace rs, const char* name, CodeBlobType code_blob_type);
   static CodeHeap* get_code_heap_containing(void* p);         // Returns the CodeHeap containing the given pointer, or nullptr
   static CodeHeap* get_code_heap(const void* cb);             // Returns the CodeHeap for the given CodeBlob
   static CodeHeap* get_code_heap(CodeBlobType code_blob_type);         // Returns the CodeHeap for the given CodeBlobType
@@ -146,6 +167,10 @@ class CodeCache : AllStatic {
 
   // Allocation/administration
   static CodeBlob* allocate(uint size, CodeBlobType code_blob_type, bool handle_alloc_failure = true, CodeBlobType orig_code_blob_type = CodeBlobType::All); // allocates a new CodeBlob
+  static CodeBlob* allocate_hot(uint size);                // allocates in the hot code heap, or returns null
+  static bool is_hot_candidate(const Method* method, int comp_level); // should the method's code go to the hot code heap?
+  static bool is_hot_method(const Method* method, int comp_level);    // is the method's code considered hot?
+  static bool is_in_hot_heap(const void* p) { return _hot_heap != nullptr && _hot_heap->contains(p); }
   static void commit(CodeBlob* cb);                        // called when the allocated CodeBlob has been filled
   static void free(CodeBlob* cb);                          // frees a CodeBlob
   static void free_unused_tail(CodeBlob* cb, size_t used); // frees the unused tail of a CodeBlob (only used by TemplateInterpreter::initialize())
@@ -189,6 +214,11 @@ class CodeCache : AllStatic {
   static uint64_t cold_gc_count();
   static void update_cold_gc_count();
   static void gc_on_allocation();
+  // Request an unloading GC instead of stopping compilation. The GC is issued
+  // by the next gc_on_allocation(), as the caller may hold locks.
+  static void request_aggressive_unloading();
+  static bool aggressive_unloading_requested();
+  static void record_unloading(nmethod* nm, bool is_cold);
 
   // The GC epoch and marking_cycle code below is there to support sweeping
   // nmethods in loom stack chunks.
@@ -27,6 +27,7 @@
 #include "code/codeCache.hpp"
 #include "code/compiledIC.hpp"
 #include "code/nmethod.hpp"
+#include "code/scopeDesc.hpp"
 #include "code/vtableStubs.hpp"
 #include "memory/resourceArea.hpp"
 #include "memory/universe.hpp"
@@ -39,6 +40,9 @@
 #include "runtime/interfaceSupport.inline.hpp"
 #include "runtime/sharedRuntime.hpp"
 #include "sanitizers/leak.hpp"
+#if INCLUDE_JFR
+#include "jfr/jfrEvents.hpp"
+#endif
 
 
 // Every time a compiled IC is changed or its type is being accessed,
@@ -278,8 +282,36 @@ void CompiledIC::update(CallInfo* call_info, Klass* receiver_klass) {
     // If the dynamic type speculation fails, we try to transform to a megamorphic state
     // for the inline cache using stubs to dispatch in tables
     set_to_megamorphic(call_info);
+    JFR_ONLY(if (is_megamorphic()) post_megamorphic_event(call_info, receiver_klass);)
+  }
+}
+
+#if INCLUDE_JFR
+// Each call site goes megamorphic at most once per nmethod, so posting an
+// event per transition is cheap. Aggregating the events by caller and bci
+// gives the megamorphic transitions per call site.
+void CompiledIC::post_megamorphic_event(CallInfo* call_info, Klass* receiver_klass) {
+  EventInlineCacheMegamorphic event;
+  if (event.should_commit()) {
+    ResourceMark rm;
+    PcDesc* pd = _method->pc_desc_at(end_of_call());
+    if (pd != nullptr) {
+      ScopeDesc* sd = _method->scope_desc_at(end_of_call());
+      event.set_caller(sd->method());
+      event.set_bci(sd->bci());
+    } else {
+      event.set_caller(_method->method());
+      event.set_bci(-1);
+    }
+    event.set_compileId(_method->compile_id());
+    event.set_callee(call_info->resolved_method());
+    event.set_speculatedClass(data()->speculated_klass());
+    event.set_receiverClass(receiver_klass);
+    event.set_interfaceCall(call_info->call_kind() == CallInfo::itable_call);
+    event.commit();
   }
 }
+#endif // INCLUDE_JFR
 
 bool CompiledIC::is_clean() const {
   return destination() == SharedRuntime::get_resolve_virtual_call_stub();
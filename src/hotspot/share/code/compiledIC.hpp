@@ -113,6 +113,9 @@ class CompiledIC: public ResourceObj {
   void set_to_monomorphic();
   void set_to_megamorphic(CallInfo* call_info);
 
+  // Report a monomorphic to megamorphic transition to JFR
+  void post_megamorphic_event(CallInfo* call_info, Klass* receiver_klass) NOT_JFR_RETURN();
+
 public:
   // conversion (machine PC to CompiledIC*)
   friend CompiledIC* CompiledIC_before(nmethod* nm, address return_addr);
@@ -1179,7 +1179,7 @@ nmethod* nmethod::new_nmethod(const methodHandle& method,
   {
     MutexLocker mu(CodeCache_lock, Mutex::_no_safepoint_check_flag);
 
-    nm = new (nmethod_size, comp_level)
+    nm = new (nmethod_size, comp_level, CodeCache::is_hot_candidate(method(), comp_level))
     nmethod(method(), compiler->type(), nmethod_size, immutable_data_size,
             compile_id, entry_bci, immutable_data, offsets, orig_pc_offset,
             debug_info, dependencies, code_buffer, frame_size, oop_maps,
@@ -1401,6 +1401,14 @@ void* nmethod::operator new(size_t size, int nmethod_size, int comp_level) throw
   return CodeCache::allocate(nmethod_size, CodeCache::get_code_blob_type(comp_level));
 }
 
+void* nmethod::operator new(size_t size, int nmethod_size, int comp_level, bool hot) throw () {
+  if (hot) {
+    void* return_value = CodeCache::allocate_hot(nmethod_size);
+    if (return_value != nullptr) return return_value;
+  }
+  return CodeCache::allocate(nmethod_size, CodeCache::get_code_blob_type(comp_level));
+}
+
 void* nmethod::operator new(size_t size, int nmethod_size, bool allow_NonNMethod_space) throw () {
   // Try MethodNonProfiled and MethodProfiled.
   void* return_value = CodeCache::allocate(nmethod_size, CodeBlobType::MethodNonProfiled);
@@ -2331,8 +2339,17 @@ bool nmethod::is_cold() {
     return false;
   }
 
-  // Other code can be phased out more gradually after N GCs
-  return CodeCache::previous_completed_gc_marking_cycle() > _gc_epoch + 2 * CodeCache::cold_gc_count();
+  // Other code can be phased out more gradually after N GCs.
+  // Hot code gets more time, so that under pressure cold code goes first.
+  uint64_t cold_gc_count = CodeCache::cold_gc_count();
+  if (HotnessBasedCodeCacheFlushing && is_hot()) {
+    cold_gc_count *= 4;
+  }
+  return CodeCache::previous_completed_gc_marking_cycle() > _gc_epoch + 2 * cold_gc_count;
+}
+
+bool nmethod::is_hot() {
+  return CodeCache::is_in_hot_heap(this) || CodeCache::is_hot_method(method(), comp_level());
 }
 
 // The _is_unloading_state encodes a tuple comprising the unloading cycle
@@ -2403,6 +2420,9 @@ bool nmethod::is_unloading() {
 
   if (found_state == state) {
     // First to change state, we win
+    if (state_is_unloading) {
+      CodeCache::record_unloading(this, is_cold());
+    }
     return state_is_unloading;
   } else {
     // State already set, so use it
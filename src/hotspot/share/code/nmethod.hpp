@@ -340,6 +340,8 @@ class nmethod : public CodeBlob {
 
   // helper methods
   void* operator new(size_t size, int nmethod_size, int comp_level) throw();
+  // Same as above, but tries the hot code heap first if hot is true.
+  void* operator new(size_t size, int nmethod_size, int comp_level, bool hot) throw();
 
   // For method handle intrinsics: Try MethodNonProfiled, MethodProfiled and NonNMethod.
   // Attention: Only allow NonNMethod space for special nmethods which don't need to be
@@ -626,6 +628,8 @@ class nmethod : public CodeBlob {
   void clear_unloading_state();
   // Heuristically deduce an nmethod isn't worth keeping around
   bool is_cold();
+  // Is this code hot enough to be kept longer when unused? See HotnessBasedCodeCacheFlushing.
+  bool is_hot();
   bool is_unloading();
   void do_unloading(bool unloading_occurred);
 
@@ -24,6 +24,7 @@
 #include "precompiled.hpp"
 #include "compiler/abstractCompiler.hpp"
 #include "compiler/compileBroker.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/mutexLocker.hpp"
 
 bool AbstractCompiler::should_perform_init() {
@@ -62,3 +63,20 @@ void AbstractCompiler::set_state(int state) {
   _compiler_state =  state;
   CompileThread_lock->notify_all();
 }
+
+void AbstractCompiler::update_throughput(int bytes, elapsedTimer time) {
+  assert_lock_strong(CompileStatistics_lock);
+  // Each compilation weighs 1% less than the following one, so the estimate
+  // follows the recent compilations and the sums cannot overflow.
+  const double decay = 0.99;
+  _decayed_bytes = _decayed_bytes * decay + bytes;
+  _decayed_seconds = _decayed_seconds * decay + time.seconds();
+  if (_decayed_seconds > 0.0) {
+    double bytes_per_second = MIN2(_decayed_bytes / _decayed_seconds, (double)max_juint);
+    Atomic::store(&_recent_bytes_per_second, (uint)bytes_per_second);
+  }
+}
+
+uint AbstractCompiler::recent_bytes_per_second() const {
+  return Atomic::load(&_recent_bytes_per_second);
+}
@@ -90,8 +90,16 @@ class AbstractCompiler : public CHeapObj<mtCompiler> {
 
   CompilerStatistics _stats;
 
+  // Decaying sums of the bytes compiled and the time spent compiling them,
+  // and their ratio, for estimating the cost of queued compile tasks.
+  // Updated under CompileStatistics_lock.
+  double        _decayed_bytes;
+  double        _decayed_seconds;
+  volatile uint _recent_bytes_per_second;
+
  public:
-  AbstractCompiler(CompilerType type) : _num_compiler_threads(0), _compiler_state(uninitialized), _type(type) {}
+  AbstractCompiler(CompilerType type) : _num_compiler_threads(0), _compiler_state(uninitialized), _type(type),
+    _decayed_bytes(0.0), _decayed_seconds(0.0), _recent_bytes_per_second(0) {}
 
   // This function determines the compiler thread that will perform the
   // shutdown of the corresponding compiler runtime.
@@ -188,6 +196,11 @@ class AbstractCompiler : public CHeapObj<mtCompiler> {
   }
 
   CompilerStatistics* stats() { return &_stats; }
+
+  // Account a successful compilation in the recent throughput.
+  void update_throughput(int bytes, elapsedTimer time);
+  // The recent compilation throughput, 0 if there is no history yet.
+  uint recent_bytes_per_second() const;
 };
 
 #endif // SHARE_COMPILER_ABSTRACTCOMPILER_HPP
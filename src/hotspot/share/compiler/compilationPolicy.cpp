@@ -109,6 +109,40 @@ void CompilationPolicy::compile_if_required(const methodHandle& m, TRAPS) {
   }
 }
 
+#if INCLUDE_CDS
+void CompilationPolicy::compile_trained_methods(InstanceKlass* ik, TRAPS) {
+  assert(ik->is_shared() && ik->is_initialized(), "sanity");
+  if (!UseCompiler || !THREAD->can_call_java() || THREAD->is_Compiler_thread()) {
+    return;
+  }
+  CompLevel level = highest_compile_level();
+  if (level != CompLevel_full_optimization) {
+    return;
+  }
+  Array<Method*>* methods = ik->methods();
+  for (int i = 0; i < methods->length(); i++) {
+    Method* m = methods->at(i);
+    // The archived MethodData is dropped at runtime if it cannot be used. C2 would have
+    // to start from an empty profile then, so don't compile the method early.
+    if (!m->has_trained_code() || m->method_data() == nullptr || m->has_compiled_code()) {
+      continue;
+    }
+    methodHandle mh(THREAD, m);
+    if (!can_be_compiled(mh, level) || CompileBroker::compilation_is_in_queue(mh)) {
+      continue;
+    }
+    if (PrintTieredEvents) {
+      print_event(COMPILE, mh(), mh(), InvocationEntryBci, level);
+    }
+    CompileBroker::compile_method(mh, InvocationEntryBci, level, methodHandle(), 0, CompileTask::Reason_Trained, THREAD);
+    if (HAS_PENDING_EXCEPTION) {
+      // The compilation request is only a hint; don't let it fail the class initialization.
+      CLEAR_PENDING_EXCEPTION;
+    }
+  }
+}
+#endif // INCLUDE_CDS
+
 static inline CompLevel adjust_level_for_compilability_query(CompLevel comp_level) {
   if (comp_level == CompLevel_any) {
      if (CompilerConfig::is_c1_only()) {
@@ -617,58 +651,73 @@ void CompilationPolicy::handle_counter_overflow(const methodHandle& method) {
   }
 }
 
+// Remove a task that has been unloaded or has been stale for some time.
+// Blocking tasks and tasks submitted from whitebox API don't become stale.
+bool CompilationPolicy::remove_if_stale(CompileQueue* compile_queue, CompileTask* task, jlong t) {
+  if (task->is_unloaded()) {
+    compile_queue->remove_and_mark_stale(task);
+    return true;
+  }
+  Method* method = task->method();
+  methodHandle mh(Thread::current(), method);
+  if (task->can_become_stale() && is_stale(t, TieredCompileTaskTimeout, mh) && !is_old(mh)) {
+    if (PrintTieredEvents) {
+      print_event(REMOVE_FROM_QUEUE, method, method, task->osr_bci(), (CompLevel) task->comp_level());
+    }
+    method->clear_queued_for_compilation();
+    compile_queue->remove_and_mark_stale(task);
+    return true;
+  }
+  return false;
+}
+
+// Refresh the rate of the task's method and reposition the task in the queue.
+void CompilationPolicy::refresh_priority(CompileQueue* compile_queue, CompileTask* task, jlong t) {
+  Method* method = task->method();
+  methodHandle mh(Thread::current(), method);
+  update_rate(t, mh);
+  compile_queue->update_priority(task, method->highest_comp_level(), weight(method));
+}
+
+// Tasks are kept in a heap ordered by the priority computed when they were
+// queued or last refreshed. Rates change over time, so instead of refreshing
+// every queued task on each selection we only refresh the top of the heap,
+// until a task refreshed during this selection stays on top. Every
+// TieredCompileTaskTimeout milliseconds all tasks are refreshed, which also
+// purges the stale ones that never make it to the top.
 // Called with the queue locked and with at least one element
 CompileTask* CompilationPolicy::select_task(CompileQueue* compile_queue) {
-  CompileTask *max_blocking_task = nullptr;
   CompileTask *max_task = nullptr;
   Method* max_method = nullptr;
 
   jlong t = nanos_to_millis(os::javaTimeNanos());
-  // Iterate through the queue and find a method with a maximum rate.
-  for (CompileTask* task = compile_queue->first(); task != nullptr;) {
-    CompileTask* next_task = task->next();
-    // If a method was unloaded or has been stale for some time, remove it from the queue.
-    // Blocking tasks and tasks submitted from whitebox API don't become stale
-    if (task->is_unloaded()) {
-      compile_queue->remove_and_mark_stale(task);
-      task = next_task;
-      continue;
-    }
-    Method* method = task->method();
-    methodHandle mh(Thread::current(), method);
-    if (task->can_become_stale() && is_stale(t, TieredCompileTaskTimeout, mh) && !is_old(mh)) {
-      if (PrintTieredEvents) {
-        print_event(REMOVE_FROM_QUEUE, method, method, task->osr_bci(), (CompLevel) task->comp_level());
+  uint epoch = compile_queue->next_epoch();
+  if (t - compile_queue->last_rescan_time() >= TieredCompileTaskTimeout) {
+    compile_queue->set_last_rescan_time(t);
+    for (CompileTask* task = compile_queue->first(); task != nullptr;) {
+      CompileTask* next_task = task->next();
+      if (!remove_if_stale(compile_queue, task, t)) {
+        Method* method = task->method();
+        methodHandle mh(Thread::current(), method);
+        update_rate(t, mh);
+        task->set_priority(method->highest_comp_level(), weight(method), epoch);
       }
-      method->clear_queued_for_compilation();
-      compile_queue->remove_and_mark_stale(task);
       task = next_task;
+    }
+    compile_queue->rebuild_heap();
+  }
+
+  for (CompileTask* task = compile_queue->highest(); task != nullptr; task = compile_queue->highest()) {
+    if (remove_if_stale(compile_queue, task, t)) {
       continue;
     }
-    update_rate(t, mh);
-    if (max_task == nullptr || compare_methods(method, max_method)) {
-      // Select a method with the highest rate
+    if (task->queue_epoch() == epoch) {
+      // Up to date and still ahead of everything else.
       max_task = task;
-      max_method = method;
-    }
-
-    if (task->is_blocking()) {
-      if (max_blocking_task == nullptr || compare_methods(method, max_blocking_task->method())) {
-        max_blocking_task = task;
-      }
+      max_method = task->method();
+      break;
     }
-
-    task = next_task;
-  }
-
-  if (max_blocking_task != nullptr) {
-    // In blocking compilation mode, the CompileBroker will make
-    // compilations submitted by a JVMCI compiler thread non-blocking. These
-    // compilations should be scheduled after all blocking compilations
-    // to service non-compiler related compilations sooner and reduce the
-    // chance of such compilations timing out.
-    max_task = max_blocking_task;
-    max_method = max_task->method();
+    refresh_priority(compile_queue, task, t);
   }
 
   methodHandle max_method_h(Thread::current(), max_method);
@@ -877,20 +926,6 @@ double CompilationPolicy::weight(Method* method) {
   return (double)(method->rate() + 1) * (method->invocation_count() + 1) * (method->backedge_count() + 1);
 }
 
-// Apply heuristics and return true if x should be compiled before y
-bool CompilationPolicy::compare_methods(Method* x, Method* y) {
-  if (x->highest_comp_level() > y->highest_comp_level()) {
-    // recompilation after deopt
-    return true;
-  } else
-    if (x->highest_comp_level() == y->highest_comp_level()) {
-      if (weight(x) > weight(y)) {
-        return true;
-      }
-    }
-  return false;
-}
-
 // Is method profiled enough?
 bool CompilationPolicy::is_method_profiled(const methodHandle& method) {
   MethodData* mdo = method->method_data();
@@ -201,13 +201,13 @@ class CompilationPolicy : AllStatic {
   // Was a given method inactive for a given number of milliseconds.
   // If it is, we would remove it from the queue (see select_task()).
   inline static bool is_stale(jlong t, jlong timeout, const methodHandle& method);
-  // Compute the weight of the method for the compilation scheduling
-  inline static double weight(Method* method);
-  // Apply heuristics and return true if x should be compiled before y
-  inline static bool compare_methods(Method* x, Method* y);
   // Compute event rate for a given method. The rate is the number of event (invocations + backedges)
   // per millisecond.
   inline static void update_rate(jlong t, const methodHandle& method);
+  // Helpers for select_task(): drop a task that is no longer worth compiling,
+  // and recompute the priority of a queued task.
+  static bool remove_if_stale(CompileQueue* compile_queue, CompileTask* task, jlong t);
+  static void refresh_priority(CompileQueue* compile_queue, CompileTask* task, jlong t);
   // Compute threshold scaling coefficient
   inline static double threshold_scale(CompLevel level, int feedback_k);
   // If a method is old enough and is still in the interpreter we would want to
@@ -255,6 +255,10 @@ class CompilationPolicy : AllStatic {
   // This supports the -Xcomp option.
   static void compile_if_required(const methodHandle& m, TRAPS);
 
+  // Request background compilations of the methods of ik that were compiled at the
+  // highest tier in the run that dumped the CDS archive. Called when ik is initialized.
+  static void compile_trained_methods(InstanceKlass* ik, TRAPS) NOT_CDS_RETURN;
+
   // m is allowed to be compiled
   static bool can_be_compiled(const methodHandle& m, int comp_level = CompLevel_any);
   // m is allowed to be osr compiled
@@ -268,6 +272,9 @@ class CompilationPolicy : AllStatic {
                         int branch_bci, int bci, CompLevel comp_level, nmethod* nm, TRAPS);
   // Select task is called by CompileBroker. We should return a task or nullptr.
   static CompileTask* select_task(CompileQueue* compile_queue);
+  // Compute the weight of the method for the compilation scheduling.
+  // CompileQueue orders its tasks by snapshots of this value.
+  static double weight(Method* method);
   // Tell the runtime if we think a given method is adequately profiled.
   static bool is_mature(Method* method);
   // Initialize: set compiler thread count
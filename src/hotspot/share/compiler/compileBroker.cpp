@@ -310,6 +310,76 @@ bool CompileBroker::can_remove(CompilerThread *ct, bool do_it) {
   return false;
 }
 
+CompileQueue::CompileQueue(const char* name) :
+  _name(name),
+  _first(nullptr),
+  _last(nullptr),
+  _first_stale(nullptr),
+  _heap(),
+  _epoch(0),
+  _last_rescan_time(0),
+  _estimated_backlog(0),
+  _size(0),
+  _peak_size(0),
+  _total_added(0),
+  _total_removed(0),
+  _perf_wait_time(nullptr),
+  _perf_estimated_backlog(nullptr) {
+  for (int i = 0; i < wait_histogram_buckets; i++) {
+    _perf_wait_histogram[i] = nullptr;
+  }
+}
+
+static const jlong wait_histogram_bounds_ms[CompileQueue::wait_histogram_buckets - 1] = { 1, 10, 100, 1000 };
+
+void CompileQueue::initialize_perf_counters(const char* perf_name, TRAPS) {
+  ResourceMark rm;
+  _perf_wait_time =
+    PerfDataManager::create_counter(SUN_CI, PerfDataManager::counter_name(perf_name, "waitTime"),
+                                    PerfData::U_Ticks, CHECK);
+  for (int i = 0; i < wait_histogram_buckets; i++) {
+    char bucket[32];
+    if (i < wait_histogram_buckets - 1) {
+      os::snprintf_checked(bucket, sizeof(bucket), "wait.lt%ldms", (long)wait_histogram_bounds_ms[i]);
+    } else {
+      os::snprintf_checked(bucket, sizeof(bucket), "wait.ge%ldms", (long)wait_histogram_bounds_ms[i - 1]);
+    }
+    _perf_wait_histogram[i] =
+      PerfDataManager::create_counter(SUN_CI, PerfDataManager::counter_name(perf_name, bucket),
+                                      PerfData::U_Events, CHECK);
+  }
+  _perf_estimated_backlog =
+    PerfDataManager::create_variable(SUN_CI, PerfDataManager::counter_name(perf_name, "estimatedBacklog"),
+                                     PerfData::U_None, CHECK);
+}
+
+// Account the time the task has spent in the queue before it was picked
+// up by a compiler thread.
+void CompileQueue::record_wait_time(CompileTask* task) {
+  if (_perf_wait_time == nullptr) {
+    return;
+  }
+  jlong wait = os::elapsed_counter() - task->time_queued();
+  _perf_wait_time->inc(wait);
+  jlong wait_ms = (jlong)(wait * 1000.0 / os::elapsed_frequency());
+  int bucket = 0;
+  while (bucket < wait_histogram_buckets - 1 && wait_ms >= wait_histogram_bounds_ms[bucket]) {
+    bucket++;
+  }
+  _perf_wait_histogram[bucket]->inc();
+}
+
+void CompileQueue::update_priority(CompileTask* task, int level, double weight) {
+  assert(MethodCompileQueue_lock->owned_by_self(), "must own lock");
+  task->set_priority(level, weight, _epoch);
+  _heap.update(task);
+}
+
+void CompileQueue::rebuild_heap() {
+  assert(MethodCompileQueue_lock->owned_by_self(), "must own lock");
+  _heap.rebuild();
+}
+
 /**
  * Add a CompileTask to a CompileQueue.
  */
@@ -337,6 +407,15 @@ void CompileQueue::add(CompileTask* task) {
     _peak_size = _size;
   }
 
+  // Index the task by the priority the policy has just computed for it.
+  Method* method = task->method();
+  task->set_priority(method->highest_comp_level(), CompilationPolicy::weight(method), _epoch);
+  _heap.add(task);
+  _estimated_backlog += task->estimated_cost();
+  if (_perf_estimated_backlog != nullptr) {
+    _perf_estimated_backlog->set_value(_estimated_backlog);
+  }
+
   // Mark the method as being in the compile queue.
   task->method()->set_queued_for_compilation();
 
@@ -376,6 +455,8 @@ void CompileQueue::free_all() {
   }
   _first = nullptr;
   _last = nullptr;
+  _heap.clear();
+  _estimated_backlog = 0;
 
   // Wake up all threads that block on the queue.
   MethodCompileQueue_lock->notify_all();
@@ -446,6 +527,7 @@ CompileTask* CompileQueue::get(CompilerThread* thread) {
     save_hot_method = methodHandle(thread, task->hot_method());
 
     remove(task);
+    record_wait_time(task);
   }
   purge_stale_tasks(); // may temporarily release MCQ lock
   return task;
@@ -491,6 +573,11 @@ void CompileQueue::remove(CompileTask* task) {
     assert(task == _last, "Sanity");
     _last = task->prev();
   }
+  _heap.remove(task);
+  _estimated_backlog -= task->estimated_cost();
+  if (_perf_estimated_backlog != nullptr) {
+    _perf_estimated_backlog->set_value(_estimated_backlog);
+  }
   --_size;
   ++_total_removed;
 }
@@ -953,11 +1040,17 @@ void CompileBroker::init_compiler_threads() {
   if (_c2_count > 0) {
     const char* name = JVMCI_ONLY(UseJVMCICompiler ? "JVMCI compile queue" :) "C2 compile queue";
     _c2_compile_queue  = new CompileQueue(name);
+    if (UsePerfData) {
+      _c2_compile_queue->initialize_perf_counters("c2Queue", CHECK);
+    }
     _compiler2_objects = NEW_C_HEAP_ARRAY(jobject, _c2_count, mtCompiler);
     _compiler2_logs = NEW_C_HEAP_ARRAY(CompileLog*, _c2_count, mtCompiler);
   }
   if (_c1_count > 0) {
     _c1_compile_queue  = new CompileQueue("C1 compile queue");
+    if (UsePerfData) {
+      _c1_compile_queue->initialize_perf_counters("c1Queue", CHECK);
+    }
     _compiler1_objects = NEW_C_HEAP_ARRAY(jobject, _c1_count, mtCompiler);
     _compiler1_logs = NEW_C_HEAP_ARRAY(CompileLog*, _c1_count, mtCompiler);
   }
@@ -1925,6 +2018,12 @@ void CompileBroker::compiler_thread_loop() {
     // We need this HandleMark to avoid leaking VM handles.
     HandleMark hm(thread);
 
+    if (CodeCache::aggressive_unloading_requested()) {
+      // Issue the unloading GC requested when the code cache became full.
+      // No locks are held here, unlike where the request was made.
+      CodeCache::gc_on_allocation();
+    }
+
     CompileTask* task = queue->get(thread);
     if (task == nullptr) {
       if (UseDynamicNumberOfCompilerThreads) {
@@ -2434,7 +2533,11 @@ void CompileBroker::handle_full_code_cache(CodeBlobType code_blob_type) {
       vm_direct_exit(1);
     }
 #endif
-    if (UseCodeCacheFlushing) {
+    if (UseCodeCacheFlushing && HotnessBasedCodeCacheFlushing) {
+      // Keep compiling; compilations that don't fit bail out until the
+      // unloading GC has made room by removing cold nmethods.
+      CodeCache::request_aggressive_unloading();
+    } else if (UseCodeCacheFlushing) {
       // Since code cache is full, immediately stop new compiles
       if (CompileBroker::set_should_compile_new_jobs(CompileBroker::stop_compilation)) {
         log_info(codecache)("Code cache is full - disabling compilation");
@@ -2540,6 +2643,12 @@ void CompileBroker::collect_statistics(CompilerThread* thread, elapsedTimer time
     _perf_total_compilation->inc(time.ticks());
     _peak_compilation_time = time.milliseconds() > _peak_compilation_time ? time.milliseconds() : _peak_compilation_time;
 
+    // Feed the cost estimate of queued tasks, see CompileTask::estimate_cost().
+    AbstractCompiler* comp = compiler(comp_level);
+    if (comp != nullptr) {
+      comp->update_throughput(method->code_size() + task->num_inlined_bytecodes(), time);
+    }
+
     if (CITime) {
       int bytes_compiled = method->code_size() + task->num_inlined_bytecodes();
       if (is_osr) {
@@ -2565,7 +2674,6 @@ void CompileBroker::collect_statistics(CompilerThread* thread, elapsedTimer time
       }
 
       // Collect statistic per compiler
-      AbstractCompiler* comp = compiler(comp_level);
       if (comp) {
         CompilerStatistics* stats = comp->stats();
         if (is_osr) {
@@ -28,6 +28,7 @@
 #include "ci/compilerInterface.hpp"
 #include "compiler/abstractCompiler.hpp"
 #include "compiler/compileTask.hpp"
+#include "compiler/compileTaskHeap.hpp"
 #include "compiler/compilerDirectives.hpp"
 #include "compiler/compilerThread.hpp"
 #include "runtime/atomic.hpp"
@@ -77,8 +78,17 @@ class CompilerCounters : public CHeapObj<mtCompiler> {
 
 // CompileQueue
 //
-// A list of CompileTasks.
+// A list of CompileTasks. In addition to the list, which keeps the tasks
+// in arrival order, the queue maintains a binary max-heap over the same
+// tasks, ordered by CompileTask::has_higher_priority_than(). The policy
+// picks the next task from the top of the heap instead of scanning the
+// whole list.
 class CompileQueue : public CHeapObj<mtCompiler> {
+ public:
+  // Upper bounds, in milliseconds, of the queue wait time histogram buckets.
+  // The last bucket collects everything above the second-to-last bound.
+  enum { wait_histogram_buckets = 5 };
+
  private:
   const char* _name;
 
@@ -87,32 +97,49 @@ class CompileQueue : public CHeapObj<mtCompiler> {
 
   CompileTask* _first_stale;
 
+  CompileTaskHeap _heap;
+  uint  _epoch;             // incremented for every task selection
+  jlong _last_rescan_time;  // milliseconds, see CompilationPolicy::select_task()
+  jlong _estimated_backlog; // sum of estimated_cost() of all queued tasks
+
   int _size;
   int _peak_size;
   uint _total_added;
   uint _total_removed;
 
+  PerfCounter*  _perf_wait_time;
+  PerfCounter*  _perf_wait_histogram[wait_histogram_buckets];
+  PerfVariable* _perf_estimated_backlog;
+
   void purge_stale_tasks();
+
+  void record_wait_time(CompileTask* task);
  public:
-  CompileQueue(const char* name) {
-    _name = name;
-    _first = nullptr;
-    _last = nullptr;
-    _size = 0;
-    _total_added = 0;
-    _total_removed = 0;
-    _peak_size = 0;
-    _first_stale = nullptr;
-  }
+  CompileQueue(const char* name);
 
   const char*  name() const                      { return _name; }
 
+  void         initialize_perf_counters(const char* perf_name, TRAPS);
+
   void         add(CompileTask* task);
   void         remove(CompileTask* task);
   void         remove_and_mark_stale(CompileTask* task);
   CompileTask* first()                           { return _first; }
   CompileTask* last()                            { return _last;  }
 
+  // The task with the highest priority, based on the priority snapshots
+  // taken when the tasks were queued or last refreshed.
+  CompileTask* highest() const                   { return _heap.first(); }
+  // Refresh the priority of a queued task and restore the heap order.
+  void         update_priority(CompileTask* task, int level, double weight);
+  // Start a new selection; tasks refreshed before that are considered stale.
+  uint         next_epoch()                      { return ++_epoch; }
+  uint         epoch() const                     { return _epoch; }
+  // Rebuild the heap after the priorities of many tasks have been refreshed.
+  void         rebuild_heap();
+  jlong        last_rescan_time() const          { return _last_rescan_time; }
+  void         set_last_rescan_time(jlong t)     { _last_rescan_time = t; }
+
   CompileTask* get(CompilerThread* thread);
 
   bool         is_empty() const                  { return _first == nullptr; }
@@ -121,6 +148,7 @@ class CompileQueue : public CHeapObj<mtCompiler> {
   int         get_peak_size()     const          { return _peak_size; }
   uint        get_total_added()   const          { return _total_added; }
   uint        get_total_removed() const          { return _total_removed; }
+  jlong       estimated_backlog() const          { return _estimated_backlog; }
 
   // Redefine Classes support
   void mark_on_stack();
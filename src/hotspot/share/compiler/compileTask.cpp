@@ -124,6 +124,11 @@ void CompileTask::initialize(int compile_id,
   _failure_reason = nullptr;
   _failure_reason_on_C_heap = false;
   _arena_bytes = 0;
+  _queue_index = -1;
+  _queue_epoch = 0;
+  _queue_level = method->highest_comp_level();
+  _queue_weight = 0.0;
+  _estimated_cost = estimate_cost(method, comp_level, osr_bci != InvocationEntryBci);
 
   if (LogCompilation) {
     if (hot_method.not_null()) {
@@ -140,6 +145,41 @@ void CompileTask::initialize(int compile_id,
   _next = nullptr;
 }
 
+// Estimate how long the compilation will take, in microseconds, from the
+// bytecode size and the throughput of the compiler's recent compilations.
+// Until a compiler has some history, a fixed guess per tier is used instead.
+jlong CompileTask::estimate_cost(const methodHandle& method, int comp_level, bool is_osr) {
+  AbstractCompiler* comp = CompileBroker::compiler(comp_level);
+  double bytes_per_second = (comp != nullptr) ? comp->recent_bytes_per_second() : 0.0;
+  if (bytes_per_second == 0.0) {
+    bytes_per_second = is_c2_compile(comp_level) ? 10000.0 : 100000.0;
+  }
+  // OSR compilations usually inline the loop body's callees as well.
+  double bytes = (double)method->code_size() * (is_osr ? 2 : 1);
+  return (jlong)(bytes * 1000000.0 / bytes_per_second) + 1;
+}
+
+bool CompileTask::has_higher_priority_than(const CompileTask* other) const {
+  // Blocking compilations go first so that waiting threads are released
+  // sooner and JVMCI-submitted non-blocking compiles can't time them out.
+  if (_is_blocking != other->_is_blocking) {
+    return _is_blocking;
+  }
+  // Recompilation after deopt.
+  if (_queue_level != other->_queue_level) {
+    return _queue_level > other->_queue_level;
+  }
+  if (_queue_weight != other->_queue_weight) {
+    return _queue_weight > other->_queue_weight;
+  }
+  // For equally hot methods, cheaper compilations pay off sooner.
+  if (_estimated_cost != other->_estimated_cost) {
+    return _estimated_cost < other->_estimated_cost;
+  }
+  // Keep FIFO order otherwise.
+  return _compile_id < other->_compile_id;
+}
+
 /**
  * Returns the compiler for this task.
  */
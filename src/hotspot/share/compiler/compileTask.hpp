@@ -49,6 +49,7 @@ inline InliningResult inlining_result_of(bool success) {
 class CompileTask : public CHeapObj<mtCompiler> {
   friend class VMStructs;
   friend class JVMCIVMStructs;
+  friend class CompileTaskHeapTest;
 
  public:
   // Different reasons for a compilation
@@ -62,6 +63,7 @@ class CompileTask : public CHeapObj<mtCompiler> {
       Reason_Whitebox,         // Whitebox API
       Reason_MustBeCompiled,   // Used for -Xcomp or AlwaysCompileLoopMethods (see CompilationPolicy::must_be_compiled())
       Reason_Bootstrap,        // JVMCI bootstrap
+      Reason_Trained,          // Method was compiled at the highest tier in the CDS training run
       Reason_Count
   };
 
@@ -74,7 +76,8 @@ class CompileTask : public CHeapObj<mtCompiler> {
       "replay",
       "whitebox",
       "must_be_compiled",
-      "bootstrap"
+      "bootstrap",
+      "trained"
     };
     return reason_names[compile_reason];
   }
@@ -113,6 +116,12 @@ class CompileTask : public CHeapObj<mtCompiler> {
   // Specifies if _failure_reason is on the C heap.
   bool                 _failure_reason_on_C_heap;
   size_t               _arena_bytes;  // peak size of temporary memory during compilation (e.g. node arenas)
+  // Fields used by the CompileQueue priority index:
+  int                  _queue_index;  // position in the queue's heap, -1 if not queued
+  uint                 _queue_epoch;  // selection in which the priority was last refreshed
+  int                  _queue_level;  // snapshot of the method's highest compiled level
+  double               _queue_weight; // snapshot of the method's event-rate weight
+  jlong                _estimated_cost; // estimated compilation time in microseconds
 
  public:
   CompileTask() : _failure_reason(nullptr), _failure_reason_on_C_heap(false) {
@@ -202,7 +211,26 @@ class CompileTask : public CHeapObj<mtCompiler> {
   void         set_arena_bytes(size_t s)         { _arena_bytes = s; }
   size_t       arena_bytes() const               { return _arena_bytes; }
 
+  // CompileQueue priority support
+  int          queue_index() const               { return _queue_index; }
+  void         set_queue_index(int index)        { _queue_index = index; }
+  uint         queue_epoch() const               { return _queue_epoch; }
+  void         set_priority(int level, double weight, uint epoch) {
+    _queue_level = level;
+    _queue_weight = weight;
+    _queue_epoch = epoch;
+  }
+  // Returns true if this task should be compiled before the other task.
+  // Only the snapshots taken by set_priority() are compared, so neither
+  // method is touched; this is safe even if the holder has been unloaded.
+  bool         has_higher_priority_than(const CompileTask* other) const;
+
+  jlong        time_queued() const               { return _time_queued; }
+  jlong        estimated_cost() const            { return _estimated_cost; }
+
 private:
+  static jlong estimate_cost(const methodHandle& method, int comp_level, bool is_osr);
+
   static void  print_impl(outputStream* st, Method* method, int compile_id, int comp_level,
                                       bool is_osr_method = false, int osr_bci = -1, bool is_blocking = false,
                                       const char* msg = nullptr, bool short_form = false, bool cr = true,
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2024, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "compiler/compileTaskHeap.hpp"
+
+void CompileTaskHeap::sift_up(int i) {
+  CompileTask* task = _tasks.at(i);
+  while (i > 0) {
+    int parent = (i - 1) / 2;
+    if (!task->has_higher_priority_than(_tasks.at(parent))) {
+      break;
+    }
+    set(i, _tasks.at(parent));
+    i = parent;
+  }
+  set(i, task);
+}
+
+void CompileTaskHeap::sift_down(int i) {
+  CompileTask* task = _tasks.at(i);
+  int len = _tasks.length();
+  while (true) {
+    int child = 2 * i + 1;
+    if (child >= len) {
+      break;
+    }
+    if (child + 1 < len && _tasks.at(child + 1)->has_higher_priority_than(_tasks.at(child))) {
+      child++;
+    }
+    if (!_tasks.at(child)->has_higher_priority_than(task)) {
+      break;
+    }
+    set(i, _tasks.at(child));
+    i = child;
+  }
+  set(i, task);
+}
+
+void CompileTaskHeap::add(CompileTask* task) {
+  _tasks.append(task);
+  sift_up(_tasks.length() - 1);
+}
+
+void CompileTaskHeap::remove(CompileTask* task) {
+  int i = task->queue_index();
+  assert(i >= 0 && i < _tasks.length() && _tasks.at(i) == task, "task must be in the heap");
+  CompileTask* last = _tasks.pop();
+  task->set_queue_index(-1);
+  if (last != task) {
+    set(i, last);
+    sift_up(i);
+    sift_down(last->queue_index());
+  }
+}
+
+void CompileTaskHeap::update(CompileTask* task) {
+  assert(_tasks.at(task->queue_index()) == task, "task must be in the heap");
+  sift_up(task->queue_index());
+  sift_down(task->queue_index());
+}
+
+void CompileTaskHeap::rebuild() {
+  for (int i = _tasks.length() / 2 - 1; i >= 0; i--) {
+    sift_down(i);
+  }
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2024, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_COMPILER_COMPILETASKHEAP_HPP
+#define SHARE_COMPILER_COMPILETASKHEAP_HPP
+
+#include "compiler/compileTask.hpp"
+#include "utilities/growableArray.hpp"
+
+// CompileTaskHeap
+//
+// A binary max-heap of compile tasks, ordered by
+// CompileTask::has_higher_priority_than(). Each task records its position
+// in the heap in CompileTask::queue_index(), so that a queued task can be
+// removed or repositioned without searching for it.
+class CompileTaskHeap {
+ private:
+  GrowableArrayCHeap<CompileTask*, mtCompiler> _tasks;
+
+  void set(int i, CompileTask* task) {
+    _tasks.at_put(i, task);
+    task->set_queue_index(i);
+  }
+  void sift_up(int i);
+  void sift_down(int i);
+
+ public:
+  CompileTaskHeap() : _tasks() {}
+
+  int          length() const                    { return _tasks.length(); }
+  bool         is_empty() const                  { return _tasks.is_empty(); }
+  CompileTask* at(int i) const                   { return _tasks.at(i); }
+  // The task with the highest priority, or null if the heap is empty.
+  CompileTask* first() const                     { return _tasks.is_empty() ? nullptr : _tasks.first(); }
+
+  void add(CompileTask* task);
+  void remove(CompileTask* task);
+  // Restore the order after the priority of the task has changed.
+  void update(CompileTask* task);
+  // Restore the order after the priorities of many tasks have changed.
+  void rebuild();
+  void clear()                                   { _tasks.clear(); }
+};
+
+#endif // SHARE_COMPILER_COMPILETASKHEAP_HPP
@@ -948,7 +948,7 @@ class G1ContainerCardsClosure {
 
   void operator()(uint card_idx, uint length) {
     for (uint i = 0; i < length; i++) {
-      _cl.do_card(_region_idx, card_idx);
+      _cl.do_card(_region_idx, card_idx + i);
     }
   }
 };
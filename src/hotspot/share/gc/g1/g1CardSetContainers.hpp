@@ -219,8 +219,10 @@ class G1CardSetBitMap : public G1CardSetContainer {
 
   uint num_bits_set() const { return (uint)_num_bits_set; }
 
-  template <class CardVisitor>
-  void iterate(CardVisitor& found, size_t const size_in_bits, uint offset);
+  // Iterates over the set cards, applying a CardOrRangeVisitor. Fully set
+  // bitmap words are passed on as card ranges.
+  template <class CardOrRangeVisitor>
+  void iterate(CardOrRangeVisitor& found, size_t const size_in_bits, uint offset);
 
   uint next(uint const idx, size_t const size_in_bits) {
     BitMapView bm(_bits, size_in_bits);
@@ -29,6 +29,7 @@
 #include "gc/g1/g1GCPhaseTimes.hpp"
 #include "utilities/bitMap.inline.hpp"
 #include "utilities/checkedCast.hpp"
+#include "utilities/count_trailing_zeros.hpp"
 #include "utilities/globalDefinitions.hpp"
 #include "utilities/spinYield.hpp"
 
@@ -247,10 +248,37 @@ inline G1AddCardResult G1CardSetBitMap::add(uint card_idx, size_t threshold, siz
   return Found;
 }
 
-template <class CardVisitor>
-inline void G1CardSetBitMap::iterate(CardVisitor& found, size_t size_in_bits, uint offset) {
-  BitMapView bm(_bits, size_in_bits);
-  bm.iterate([&](BitMap::idx_t idx) { found(offset | (uint)idx); });
+template <class CardOrRangeVisitor>
+inline void G1CardSetBitMap::iterate(CardOrRangeVisitor& found, size_t size_in_bits, uint offset) {
+  // Process the bitmap a word at a time. Empty words are skipped, runs of
+  // completely set words are reported as a single card range so that the
+  // visitor can handle them in bulk, and only partially set words are
+  // decomposed into individual cards.
+  size_t const num_words = BitMap::calc_size_in_words(size_in_bits);
+  size_t word_idx = 0;
+  while (word_idx < num_words) {
+    BitMap::bm_word_t word = _bits[word_idx];
+    if (word == 0) {
+      word_idx++;
+      continue;
+    }
+    if (word == ~(BitMap::bm_word_t)0) {
+      size_t end_idx = word_idx + 1;
+      while (end_idx < num_words && _bits[end_idx] == ~(BitMap::bm_word_t)0) {
+        end_idx++;
+      }
+      found(offset | (uint)(word_idx * BitsPerWord), (uint)((end_idx - word_idx) * BitsPerWord));
+      word_idx = end_idx;
+      continue;
+    }
+    uint const word_base = offset | (uint)(word_idx * BitsPerWord);
+    do {
+      uint bit = count_trailing_zeros(word);
+      found(word_base | bit);
+      word &= word - 1;
+    } while (word != 0);
+    word_idx++;
+  }
 }
 
 inline size_t G1CardSetBitMap::header_size_in_bytes() {
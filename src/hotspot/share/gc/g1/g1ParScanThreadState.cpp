@@ -60,6 +60,7 @@ G1ParScanThreadState::G1ParScanThreadState(G1CollectedHeap* g1h,
                                            PreservedMarks* preserved_marks,
                                            uint worker_id,
                                            uint num_workers,
+                                           uint* worker_node_index,
                                            G1CollectionSet* collection_set,
                                            G1EvacFailureRegions* evac_failure_regions)
   : _g1h(g1h),
@@ -81,10 +82,12 @@ G1ParScanThreadState::G1ParScanThreadState(G1CollectedHeap* g1h,
     _surviving_words_length(collection_set->young_region_length() + 1),
     _old_gen_is_full(false),
     _partial_objarray_chunk_size(ParGCArrayScanChunk),
+    _num_workers(num_workers),
     _partial_array_stepper(num_workers),
     _string_dedup_requests(),
     _max_num_optional_regions(collection_set->optional_region_length()),
     _numa(g1h->numa()),
+    _worker_node_index(worker_node_index),
     _obj_alloc_stat(nullptr),
     ALLOCATION_FAILURE_INJECTOR_ONLY(_allocation_failure_inject_counter(0) COMMA)
     _preserved_marks(preserved_marks),
@@ -222,6 +225,11 @@ void G1ParScanThreadState::do_oop_evac(T* p) {
   write_ref_field_post(p, obj);
 }
 
+int G1ParScanThreadState::partial_objarray_chunk_size(int length) const {
+  return MAX2(_partial_objarray_chunk_size,
+              length / (int)(_num_workers * PartialArrayChunksPerWorker));
+}
+
 MAYBE_INLINE_EVACUATION
 void G1ParScanThreadState::do_partial_array(PartialArrayScanTask task) {
   oop from_obj = task.to_source_array();
@@ -234,11 +242,12 @@ void G1ParScanThreadState::do_partial_array(PartialArrayScanTask task) {
   assert(from_obj != to_obj, "should not be chunking self-forwarded objects");
   assert(to_obj->is_objArray(), "must be obj array");
   objArrayOop to_array = objArrayOop(to_obj);
+  int const chunk_size = partial_objarray_chunk_size(objArrayOop(from_obj)->length());
 
   PartialArrayTaskStepper::Step step
     = _partial_array_stepper.next(objArrayOop(from_obj),
                                   to_array,
-                                  _partial_objarray_chunk_size);
+                                  chunk_size);
   for (uint i = 0; i < step._ncreate; ++i) {
     push_on_queue(ScannerTask(PartialArrayScanTask(from_obj)));
   }
@@ -250,7 +259,7 @@ void G1ParScanThreadState::do_partial_array(PartialArrayScanTask task) {
   // on start/end.
   to_array->oop_iterate_range(&_scanner,
                               step._index,
-                              step._index + _partial_objarray_chunk_size);
+                              step._index + chunk_size);
 }
 
 MAYBE_INLINE_EVACUATION
@@ -268,7 +277,7 @@ void G1ParScanThreadState::start_partial_objarray(G1HeapRegionAttr dest_attr,
   PartialArrayTaskStepper::Step step
     = _partial_array_stepper.start(objArrayOop(from_obj),
                                    to_array,
-                                   _partial_objarray_chunk_size);
+                                   partial_objarray_chunk_size(objArrayOop(from_obj)->length()));
 
   // Push any needed partial scan tasks.  Pushed before processing the
   // initial chunk to allow other workers to steal while we're processing.
@@ -319,10 +328,45 @@ void G1ParScanThreadState::trim_queue_to_threshold(uint threshold) {
   } while (!_task_queue->overflow_empty());
 }
 
+bool G1ParScanThreadState::steal_from_same_node(G1ScannerTasksQueueSet* task_queues, ScannerTask& t) {
+  if (_worker_node_index == nullptr) {
+    return false;
+  }
+  uint const node_index = Atomic::load(&_worker_node_index[_worker_id]);
+  if (node_index == G1NUMA::UnknownNodeIndex) {
+    return false;
+  }
+  // Sample the queues of all workers on the same node and try the fullest one.
+  uint victim = _worker_id;
+  uint victim_size = 0;
+  for (uint i = 0; i < _num_workers; i++) {
+    if (i == _worker_id || Atomic::load(&_worker_node_index[i]) != node_index) {
+      continue;
+    }
+    uint size = task_queues->queue(i)->size();
+    if (size > victim_size) {
+      victim = i;
+      victim_size = size;
+    }
+  }
+  if (victim == _worker_id) {
+    return false;
+  }
+  return task_queues->queue(victim)->pop_global(t) == G1ScannerTasksQueue::PopResult::Success;
+}
+
 ATTRIBUTE_FLATTEN
 void G1ParScanThreadState::steal_and_trim_queue(G1ScannerTasksQueueSet* task_queues) {
+  if (_worker_node_index != nullptr) {
+    // The state may have been created by another thread, and the OS may
+    // have moved this thread to another node since the last steal.
+    Atomic::store(&_worker_node_index[_worker_id], _numa->index_of_current_thread());
+  }
   ScannerTask stolen_task;
-  while (task_queues->steal(_worker_id, stolen_task)) {
+  // Prefer work from workers on the same NUMA node, as that work most likely
+  // references memory local to that node. Fall back to stealing from any queue.
+  while (steal_from_same_node(task_queues, stolen_task) ||
+         task_queues->steal(_worker_id, stolen_task)) {
     dispatch_task(stolen_task);
     // Processing stolen task may have added tasks to our queue.
     trim_queue();
@@ -581,6 +625,7 @@ G1ParScanThreadState* G1ParScanThreadStateSet::state_for_worker(uint worker_id)
                                _preserved_marks_set.get(worker_id),
                                worker_id,
                                _num_workers,
+                               _worker_node_index,
                                _collection_set,
                                _evac_failure_regions);
   }
@@ -712,6 +757,7 @@ G1ParScanThreadStateSet::G1ParScanThreadStateSet(G1CollectedHeap* g1h,
     _preserved_marks_set(true /* in_c_heap */),
     _states(NEW_C_HEAP_ARRAY(G1ParScanThreadState*, num_workers, mtGC)),
     _rdc_buffers(NEW_C_HEAP_ARRAY(BufferNodeList, num_workers, mtGC)),
+    _worker_node_index(nullptr),
     _surviving_young_words_total(NEW_C_HEAP_ARRAY(size_t, collection_set->young_region_length() + 1, mtGC)),
     _num_workers(num_workers),
     _flushed(false),
@@ -722,6 +768,13 @@ G1ParScanThreadStateSet::G1ParScanThreadStateSet(G1CollectedHeap* g1h,
     _rdc_buffers[i] = BufferNodeList();
   }
   memset(_surviving_young_words_total, 0, (collection_set->young_region_length() + 1) * sizeof(size_t));
+
+  if (g1h->numa()->num_active_nodes() > 1) {
+    _worker_node_index = NEW_C_HEAP_ARRAY(uint, num_workers, mtGC);
+    for (uint i = 0; i < num_workers; ++i) {
+      _worker_node_index[i] = G1NUMA::UnknownNodeIndex;
+    }
+  }
 }
 
 G1ParScanThreadStateSet::~G1ParScanThreadStateSet() {
@@ -729,5 +782,6 @@ G1ParScanThreadStateSet::~G1ParScanThreadStateSet() {
   FREE_C_HEAP_ARRAY(G1ParScanThreadState*, _states);
   FREE_C_HEAP_ARRAY(size_t, _surviving_young_words_total);
   FREE_C_HEAP_ARRAY(BufferNodeList, _rdc_buffers);
+  FREE_C_HEAP_ARRAY(uint, _worker_node_index);
   _preserved_marks_set.reclaim();
 }
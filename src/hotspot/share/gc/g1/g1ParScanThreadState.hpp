@@ -86,8 +86,10 @@ class G1ParScanThreadState : public CHeapObj<mtGC> {
   // Indicates whether in the last generation (old) there is no more space
   // available for allocation.
   bool _old_gen_is_full;
-  // Size (in elements) of a partial objArray task chunk.
+  // Minimum size (in elements) of a partial objArray task chunk.
   int _partial_objarray_chunk_size;
+  // Number of workers taking part in this evacuation.
+  uint _num_workers;
   PartialArrayTaskStepper _partial_array_stepper;
   StringDedup::Requests _string_dedup_requests;
 
@@ -98,6 +100,11 @@ class G1ParScanThreadState : public CHeapObj<mtGC> {
   G1OopStarChunkedList* _oops_into_optional_regions;
 
   G1NUMA* _numa;
+  // NUMA node index of every worker, shared by all workers of this evacuation.
+  // Each worker updates its entry when it starts stealing. Used to prefer
+  // stealing from workers on the same node. nullptr if there is only a single
+  // active node.
+  uint* _worker_node_index;
   // Records how many object allocations happened at each node during copy to survivor.
   // Only starts recording when log of gc+heap+numa is enabled and its data is
   // transferred when flushed.
@@ -128,6 +135,7 @@ class G1ParScanThreadState : public CHeapObj<mtGC> {
                        PreservedMarks* preserved_marks,
                        uint worker_id,
                        uint num_workers,
+                       uint* worker_node_index,
                        G1CollectionSet* collection_set,
                        G1EvacFailureRegions* evac_failure_regions);
   virtual ~G1ParScanThreadState();
@@ -169,6 +177,16 @@ class G1ParScanThreadState : public CHeapObj<mtGC> {
   size_t flush_stats(size_t* surviving_young_words, uint num_workers, BufferNodeList* buffer_log);
 
 private:
+  // Large arrays are split into about this many chunks per worker. Larger
+  // arrays get proportionally larger chunks to keep the number of chunk claims
+  // (and task queue operations) bounded.
+  static const int PartialArrayChunksPerWorker = 64;
+
+  // Size (in elements) of the chunks an objArray of the given length is
+  // processed in. Only depends on the length, as all chunks of an array must
+  // have the same size.
+  int partial_objarray_chunk_size(int length) const;
+
   void do_partial_array(PartialArrayScanTask task);
   void start_partial_objarray(G1HeapRegionAttr dest_dir, oop from, oop to);
 
@@ -227,6 +245,13 @@ class G1ParScanThreadState : public CHeapObj<mtGC> {
   inline void trim_queue_partially();
   void steal_and_trim_queue(G1ScannerTasksQueueSet *task_queues);
 
+private:
+  // Try to steal a task from the fullest queue of another worker on the same
+  // NUMA node as this one.
+  bool steal_from_same_node(G1ScannerTasksQueueSet* task_queues, ScannerTask& t);
+
+public:
+
   Tickspan trim_ticks() const;
   void reset_trim_ticks();
 
@@ -248,6 +273,7 @@ class G1ParScanThreadStateSet : public StackObj {
   PreservedMarksSet _preserved_marks_set;
   G1ParScanThreadState** _states;
   BufferNodeList* _rdc_buffers;
+  uint* _worker_node_index;
   size_t* _surviving_young_words_total;
   uint _num_workers;
   bool _flushed;
@@ -32,6 +32,8 @@
 #include "runtime/os.hpp"
 #include "utilities/align.hpp"
 #include "utilities/bitMap.inline.hpp"
+#include "utilities/count_leading_zeros.hpp"
+#include "utilities/population_count.hpp"
 
 bool
 ParMarkBitMap::initialize(MemRegion covered_region)
@@ -102,25 +104,73 @@ ParMarkBitMap::update_live_words_in_range_cache(ParCompactionManager* cm, HeapWo
   cm->set_last_query_return(result);
 }
 
+inline const BitMap::bm_word_t* ParMarkBitMap::beg_bits_map() const {
+  return (const BitMap::bm_word_t*)_virtual_space->reserved_low_addr();
+}
+
+inline const BitMap::bm_word_t* ParMarkBitMap::end_bits_map() const {
+  return beg_bits_map() + _beg_bits.size_in_words();
+}
+
 size_t
 ParMarkBitMap::live_words_in_range_helper(HeapWord* beg_addr, oop end_obj) const
 {
   assert(beg_addr <= cast_from_oop<HeapWord*>(end_obj), "bad range");
   assert(is_marked(end_obj), "end_obj must be live");
 
-  idx_t live_bits = 0;
-
   // The bitmap routines require the right boundary to be word-aligned.
   const idx_t end_bit = addr_to_bit(cast_from_oop<HeapWord*>(end_obj));
   const idx_t range_end = align_range_end(end_bit);
 
-  idx_t beg_bit = find_obj_beg(addr_to_bit(beg_addr), range_end);
-  while (beg_bit < end_bit) {
-    idx_t tmp_end = find_obj_end(beg_bit, range_end);
-    assert(tmp_end < end_bit, "missing end bit");
-    live_bits += tmp_end - beg_bit + 1;
-    beg_bit = find_obj_beg(tmp_end + 1, range_end);
+  // Start at the first object that begins in the range; the tail of an object
+  // reaching into the range from below does not count.
+  const idx_t beg_bit = find_obj_beg(addr_to_bit(beg_addr), range_end);
+  if (beg_bit >= end_bit) {
+    return 0;
+  }
+
+  // Count the live bits a bitmap word at a time instead of object by object.
+  // All objects in the range end before end_obj, so begin and end bits pair
+  // up. For the objects within a word, (ends - begs) | ends selects exactly
+  // the bits they cover. An object crossing a word boundary is split into a
+  // part extending to the top of this word and one starting at bit 0 of the
+  // next word.
+  const BitMap::bm_word_t* const beg_map = beg_bits_map();
+  const BitMap::bm_word_t* const end_map = end_bits_map();
+  const idx_t first_word = beg_bit >> LogBitsPerWord;
+  const idx_t last_word = (end_bit - 1) >> LogBitsPerWord;
+  const idx_t beg_offset = beg_bit & (BitsPerWord - 1);
+  const idx_t end_offset = end_bit & (BitsPerWord - 1);
+  const BitMap::bm_word_t all_ones = ~(BitMap::bm_word_t)0;
+
+  idx_t live_bits = 0;
+  bool in_obj = false;
+  for (idx_t word = first_word; word <= last_word; word++) {
+    BitMap::bm_word_t begs = beg_map[word];
+    BitMap::bm_word_t ends = end_map[word];
+    if (word == first_word) {
+      const BitMap::bm_word_t mask = all_ones << beg_offset;
+      begs &= mask;
+      ends &= mask;
+    }
+    if (word == last_word && end_offset != 0) {
+      const BitMap::bm_word_t mask = ((BitMap::bm_word_t)1 << end_offset) - 1;
+      begs &= mask;
+      ends &= mask;
+    }
+    if (in_obj) {
+      begs |= 1;
+    }
+    BitMap::bm_word_t tail = 0;
+    in_obj = population_count(begs) > population_count(ends);
+    if (in_obj) {
+      const unsigned last_beg = BitsPerWord - 1 - count_leading_zeros(begs);
+      tail = all_ones << last_beg;
+      begs &= ~((BitMap::bm_word_t)1 << last_beg);
+    }
+    live_bits += population_count(((ends - begs) | ends) | tail);
   }
+  assert(!in_obj, "missing end bit");
   return bits_to_words(live_bits);
 }
 
@@ -35,6 +35,8 @@ class ParCompactionManager;
 
 class ParMarkBitMap: public CHeapObj<mtGC>
 {
+  friend class ParMarkBitMapTest;
+
 public:
   typedef BitMap::idx_t idx_t;
 
@@ -170,6 +172,10 @@ class ParMarkBitMap: public CHeapObj<mtGC>
 private:
   size_t live_words_in_range_helper(HeapWord* beg_addr, oop end_obj) const;
 
+  // The words backing the begin and end bits, as laid out by initialize().
+  inline const BitMap::bm_word_t* beg_bits_map() const;
+  inline const BitMap::bm_word_t* end_bits_map() const;
+
   bool is_live_words_in_range_in_cache(ParCompactionManager* cm, HeapWord* beg_addr) const;
   size_t live_words_in_range_use_cache(ParCompactionManager* cm, HeapWord* beg_addr, oop end_obj) const;
   void update_live_words_in_range_cache(ParCompactionManager* cm, HeapWord* beg_addr, oop end_obj, size_t result) const;
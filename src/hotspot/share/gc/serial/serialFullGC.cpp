@@ -55,6 +55,7 @@
 #include "gc/shared/space.hpp"
 #include "gc/shared/strongRootsScope.hpp"
 #include "gc/shared/weakProcessor.hpp"
+#include "gc/shared/workerThread.hpp"
 #include "memory/iterator.inline.hpp"
 #include "memory/universe.hpp"
 #include "oops/access.inline.hpp"
@@ -65,10 +66,13 @@
 #include "oops/objArrayKlass.inline.hpp"
 #include "oops/oop.inline.hpp"
 #include "oops/typeArrayOop.inline.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/os.hpp"
 #include "runtime/prefetch.inline.hpp"
 #include "utilities/align.hpp"
 #include "utilities/copy.hpp"
 #include "utilities/events.hpp"
+#include "utilities/spinYield.hpp"
 #include "utilities/stack.inline.hpp"
 #if INCLUDE_JVMCI
 #include "jvmci/jvmci.hpp"
@@ -83,6 +87,7 @@ size_t                  SerialFullGC::_preserved_count_max = 0;
 PreservedMark*          SerialFullGC::_preserved_marks = nullptr;
 STWGCTimer*             SerialFullGC::_gc_timer        = nullptr;
 SerialOldTracer*        SerialFullGC::_gc_tracer       = nullptr;
+WorkerThreads*          SerialFullGC::_workers         = nullptr;
 
 AlwaysTrueClosure   SerialFullGC::_always_true_closure;
 ReferenceProcessor* SerialFullGC::_ref_processor;
@@ -173,6 +178,132 @@ class Compacter {
   // Used for BOT update
   TenuredGeneration* _old_gen;
 
+  // For parallel compaction the spaces are split into stripes of about
+  // StripeSizeInWords. Stripes start at an object or at the start of a dead
+  // range, as recorded in phase 2, so every stripe can be walked on its own.
+  static constexpr size_t StripeSizeInWords = 256 * K;
+
+  struct Stripe {
+    uint _space_index;
+    // Source range of the stripe.
+    HeapWord* _start;
+    HeapWord* _end;
+    // Range the live objects of the stripe are moved into, given as positions
+    // (space index, address). It may span more than one space.
+    uint _dest_start_index;
+    HeapWord* _dest_start;
+    uint _dest_end_index;
+    HeapWord* _dest_end;
+    // Set once all objects of the stripe have been moved.
+    bool _compacted;
+  };
+
+  // Workers for phases 3 and 4, null if they are done by the VM thread alone.
+  WorkerThreads* _workers;
+  GrowableArrayCHeap<Stripe, mtGC> _stripes;
+
+  // Starts a new stripe at addr in the given space. Returns the address from
+  // which on the next stripe is to be started.
+  HeapWord* start_stripe(uint space_index, HeapWord* addr) {
+    if (_stripes.is_nonempty()) {
+      Stripe& prev = _stripes.at(_stripes.length() - 1);
+      if (prev._space_index == space_index) {
+        prev._end = addr;
+      }
+      prev._dest_end_index = _index;
+      prev._dest_end = _spaces[_index]._compaction_top;
+    }
+    Stripe stripe = { space_index, addr, get_space(space_index)->top(),
+                      _index, _spaces[_index]._compaction_top,
+                      _index, _spaces[_index]._compaction_top,
+                      false };
+    _stripes.append(stripe);
+    return addr + StripeSizeInWords;
+  }
+
+  void finish_stripes() {
+    if (_stripes.is_nonempty()) {
+      Stripe& last = _stripes.at(_stripes.length() - 1);
+      last._dest_end_index = _index;
+      last._dest_end = _spaces[_index]._compaction_top;
+    }
+  }
+
+  // Whether position (index1, addr1) is at or before position (index2, addr2)
+  // in compaction order.
+  static bool is_at_or_before(uint index1, HeapWord* addr1, uint index2, HeapWord* addr2) {
+    return index1 < index2 || (index1 == index2 && addr1 <= addr2);
+  }
+
+  // Objects only move towards lower positions in compaction order, so a
+  // stripe may only overwrite the source of earlier stripes. Wait until all of
+  // those whose source range overlaps the destination of this stripe have
+  // been compacted.
+  void wait_for_overlapping_stripes(int stripe_index) {
+    const Stripe& stripe = _stripes.at(stripe_index);
+    for (int i = stripe_index - 1; i >= 0; i--) {
+      Stripe& other = _stripes.at(i);
+      if (is_at_or_before(other._space_index, other._end, stripe._dest_start_index, stripe._dest_start)) {
+        // This and all earlier stripes end before the destination range.
+        return;
+      }
+      if (is_at_or_before(stripe._dest_end_index, stripe._dest_end, other._space_index, other._start)) {
+        // Destination range ends before this stripe.
+        continue;
+      }
+      SpinYield spin;
+      while (!Atomic::load_acquire(&other._compacted)) {
+        spin.wait();
+      }
+    }
+  }
+
+  class AdjustPointersTask : public WorkerTask {
+    Compacter* _compacter;
+    volatile uint _claimed;
+
+  public:
+    AdjustPointersTask(Compacter* compacter) :
+      WorkerTask("Serial Full GC Adjust Pointers"),
+      _compacter(compacter),
+      _claimed(0) { }
+
+    void work(uint worker_id) override {
+      uint const num_stripes = (uint)_compacter->_stripes.length();
+      for (uint i = Atomic::fetch_then_add(&_claimed, 1u);
+           i < num_stripes;
+           i = Atomic::fetch_then_add(&_claimed, 1u)) {
+        const Stripe& stripe = _compacter->_stripes.at(i);
+        _compacter->adjust_pointers_in(stripe._space_index, stripe._start, stripe._end);
+      }
+    }
+  };
+
+  class CompactTask : public WorkerTask {
+    Compacter* _compacter;
+    volatile uint _claimed;
+
+  public:
+    CompactTask(Compacter* compacter) :
+      WorkerTask("Serial Full GC Compact"),
+      _compacter(compacter),
+      _claimed(0) { }
+
+    void work(uint worker_id) override {
+      // Stripes are claimed in order and only ever wait for earlier stripes,
+      // which have all been claimed already, so this can not deadlock.
+      uint const num_stripes = (uint)_compacter->_stripes.length();
+      for (uint i = Atomic::fetch_then_add(&_claimed, 1u);
+           i < num_stripes;
+           i = Atomic::fetch_then_add(&_claimed, 1u)) {
+        _compacter->wait_for_overlapping_stripes(i);
+        Stripe& stripe = _compacter->_stripes.at(i);
+        _compacter->compact_in(stripe._space_index, stripe._start, stripe._end);
+        Atomic::release_store(&stripe._compacted, true);
+      }
+    }
+  };
+
   HeapWord* get_compaction_top(uint index) const {
     return _spaces[index]._compaction_top;
   }
@@ -267,8 +398,43 @@ class Compacter {
     return obj_size;
   }
 
+  void adjust_pointers_in(uint index, HeapWord* start, HeapWord* end) {
+    HeapWord* cur_addr = start;
+    HeapWord* const first_dead = get_first_dead(index);
+
+    while (cur_addr < end) {
+      prefetch_write_scan(cur_addr);
+      if (cur_addr < first_dead || cast_to_oop(cur_addr)->is_gc_marked()) {
+        size_t size = cast_to_oop(cur_addr)->oop_iterate_size(&SerialFullGC::adjust_pointer_closure);
+        cur_addr += size;
+      } else {
+        assert(*(HeapWord**)cur_addr > cur_addr, "forward progress");
+        cur_addr = *(HeapWord**)cur_addr;
+      }
+    }
+  }
+
+  void compact_in(uint index, HeapWord* start, HeapWord* end) {
+    HeapWord* cur_addr = start;
+    HeapWord* const first_dead = get_first_dead(index);
+
+    // Check if the first obj is forwarded.
+    if (cur_addr < first_dead && !cast_to_oop(cur_addr)->is_forwarded()) {
+      // Jump over consecutive (in-place) live-objs-chunk
+      cur_addr = first_dead;
+    }
+
+    while (cur_addr < end) {
+      if (!cast_to_oop(cur_addr)->is_forwarded()) {
+        cur_addr = *(HeapWord**) cur_addr;
+        continue;
+      }
+      cur_addr += relocate(cur_addr);
+    }
+  }
+
 public:
-  explicit Compacter(SerialHeap* heap) {
+  Compacter(SerialHeap* heap, WorkerThreads* workers) : _workers(workers), _stripes() {
     // In this order so that heap is compacted towards old-gen.
     _spaces[0].init(heap->old_gen()->space());
     _spaces[1].init(heap->young_gen()->eden());
@@ -290,12 +456,17 @@ class Compacter {
       ContiguousSpace* space = get_space(i);
       HeapWord* cur_addr = space->bottom();
       HeapWord* top = space->top();
+      // Stripes are only needed for parallel compaction.
+      HeapWord* next_stripe_start = (_workers != nullptr) ? cur_addr : top;
 
       bool record_first_dead_done = false;
 
       DeadSpacer dead_spacer(space);
 
       while (cur_addr < top) {
+        if (cur_addr >= next_stripe_start) {
+          next_stripe_start = start_stripe(i, cur_addr);
+        }
         oop obj = cast_to_oop(cur_addr);
         size_t obj_size = obj->size();
         if (obj->is_gc_marked()) {
@@ -323,48 +494,34 @@ class Compacter {
         record_first_dead(i, top);
       }
     }
+    finish_stripes();
   }
 
   void phase3_adjust_pointers() {
+    if (_workers != nullptr) {
+      AdjustPointersTask task(this);
+      _workers->run_task(&task);
+      return;
+    }
     for (uint i = 0; i < _num_spaces; ++i) {
       ContiguousSpace* space = get_space(i);
-      HeapWord* cur_addr = space->bottom();
-      HeapWord* const top = space->top();
-      HeapWord* const first_dead = get_first_dead(i);
-
-      while (cur_addr < top) {
-        prefetch_write_scan(cur_addr);
-        if (cur_addr < first_dead || cast_to_oop(cur_addr)->is_gc_marked()) {
-          size_t size = cast_to_oop(cur_addr)->oop_iterate_size(&SerialFullGC::adjust_pointer_closure);
-          cur_addr += size;
-        } else {
-          assert(*(HeapWord**)cur_addr > cur_addr, "forward progress");
-          cur_addr = *(HeapWord**)cur_addr;
-        }
-      }
+      adjust_pointers_in(i, space->bottom(), space->top());
     }
   }
 
   void phase4_compact() {
-    for (uint i = 0; i < _num_spaces; ++i) {
-      ContiguousSpace* space = get_space(i);
-      HeapWord* cur_addr = space->bottom();
-      HeapWord* top = space->top();
-
-      // Check if the first obj inside this space is forwarded.
-      if (!cast_to_oop(cur_addr)->is_forwarded()) {
-        // Jump over consecutive (in-place) live-objs-chunk
-        cur_addr = get_first_dead(i);
-      }
-
-      while (cur_addr < top) {
-        if (!cast_to_oop(cur_addr)->is_forwarded()) {
-          cur_addr = *(HeapWord**) cur_addr;
-          continue;
-        }
-        cur_addr += relocate(cur_addr);
+    if (_workers != nullptr) {
+      CompactTask task(this);
+      _workers->run_task(&task);
+    } else {
+      for (uint i = 0; i < _num_spaces; ++i) {
+        ContiguousSpace* space = get_space(i);
+        compact_in(i, space->bottom(), space->top());
       }
+    }
 
+    for (uint i = 0; i < _num_spaces; ++i) {
+      ContiguousSpace* space = get_space(i);
       // Reset top and unused memory
       space->set_top(get_compaction_top(i));
       if (ZapUnusedHeapArea) {
@@ -678,6 +835,30 @@ void SerialFullGC::initialize() {
   // to discovery, hence the _always_true_closure.
   SerialFullGC::_ref_processor = new ReferenceProcessor(&_always_true_closure);
   mark_and_push_closure.set_ref_discoverer(_ref_processor);
+
+  if (SerialFullGCParallelCompaction) {
+    // Size the workers from all CPUs rather than the ones available at startup,
+    // so that a VM started on a single CPU can compact in parallel later. The
+    // threads are only created when activated.
+    uint max_workers = (ParallelGCThreads > 0) ? ParallelGCThreads : (uint)os::processor_count();
+    SerialFullGC::_workers = new WorkerThreads("Serial Full GC Thread", max_workers);
+  }
+}
+
+WorkerThreads* SerialFullGC::compaction_workers() {
+  if (_workers == nullptr) {
+    return nullptr;
+  }
+  // The number of available CPUs may change over time, e.g. in containers.
+  uint num_workers = MIN2(_workers->max_workers(), (uint)os::active_processor_count());
+  if (num_workers > 1) {
+    num_workers = _workers->set_active_workers(num_workers);
+  }
+  if (num_workers <= 1) {
+    return nullptr;
+  }
+  log_info(gc, task)("Using %u workers of %u for full compaction", num_workers, _workers->max_workers());
+  return _workers;
 }
 
 void SerialFullGC::invoke_at_safepoint(bool clear_all_softrefs) {
@@ -700,7 +881,7 @@ void SerialFullGC::invoke_at_safepoint(bool clear_all_softrefs) {
 
   phase1_mark(clear_all_softrefs);
 
-  Compacter compacter{gch};
+  Compacter compacter{gch, compaction_workers()};
 
   {
     // Now all live objects are marked, compute the new object addresses.
@@ -39,6 +39,7 @@
 
 class SerialOldTracer;
 class STWGCTimer;
+class WorkerThreads;
 
 // Serial full GC takes care of global mark-compact garbage collection for a
 // SerialHeap using a four-phase pointer forwarding algorithm.  All
@@ -99,6 +100,11 @@ class SerialFullGC : AllStatic {
 
   static StringDedup::Requests* _string_dedup_requests;
 
+  // Threads used for adjusting pointers and compacting in parallel. Only
+  // created if SerialFullGCParallelCompaction is enabled; the threads
+  // themselves are started on first use.
+  static WorkerThreads*                  _workers;
+
   // Non public closures
   static KeepAliveClosure keep_alive;
 
@@ -135,6 +141,10 @@ class SerialFullGC : AllStatic {
   template <class T> static void mark_and_push(T* p);
 
  private:
+  // Returns the workers to use for the compaction phases of this collection,
+  // or null if they should be done by the VM thread alone.
+  static WorkerThreads* compaction_workers();
+
   // Mark live objects
   static void phase1_mark(bool clear_all_softrefs);
 
@@ -25,12 +25,16 @@
 #ifndef SHARE_GC_SERIAL_SERIAL_GLOBALS_HPP
 #define SHARE_GC_SERIAL_SERIAL_GLOBALS_HPP
 
-#define GC_SERIAL_FLAGS(develop,     \
-                        develop_pd,  \
-                        product,     \
-                        product_pd,  \
-                        range,       \
-                        constraint)
+#define GC_SERIAL_FLAGS(develop,                                            \
+                        develop_pd,                                         \
+                        product,                                            \
+                        product_pd,                                         \
+                        range,                                              \
+                        constraint)                                         \
+  product(bool, SerialFullGCParallelCompaction, false, EXPERIMENTAL,        \
+          "Use multiple threads to adjust pointers and move objects "       \
+          "during Serial full collections when more than one CPU is "       \
+          "available")
 
 // end of GC_SERIAL_FLAGS
 
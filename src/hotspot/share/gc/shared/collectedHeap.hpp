@@ -503,6 +503,9 @@ class CollectedHeap : public CHeapObj<mtGC> {
   virtual bool can_load_archived_objects() const { return false; }
   virtual HeapWord* allocate_loaded_archive_space(size_t size) { return nullptr; }
   virtual void complete_loaded_archive_space(MemRegion archive_space) { }
+  // The largest block (in words) that allocate_loaded_archive_space() can return.
+  // Larger archived heaps are loaded as several smaller, discontiguous blocks.
+  virtual size_t max_loaded_archive_space_word_size() const { return SIZE_MAX; }
 
   virtual bool is_oop(oop object) const;
   // Non product verification and debugging.
@@ -1015,6 +1015,40 @@ HeapWord* ShenandoahHeap::mem_allocate(size_t size,
   return allocate_memory(req);
 }
 
+HeapWord* ShenandoahHeap::allocate_loaded_archive_space(size_t size) {
+  // This is called during VM initialization, so we cannot wait for GC to free
+  // up space. Allocate directly from the free set.
+  ShenandoahAllocRequest req = ShenandoahAllocRequest::for_shared(size);
+  bool in_new_region = false;
+  HeapWord* result = allocate_memory_under_lock(req, in_new_region);
+  if (result != nullptr) {
+    notify_mutator_alloc_words(req.actual_size(), false);
+  }
+  if (in_new_region) {
+    notify_heap_changed();
+  }
+  return result;
+}
+
+void ShenandoahHeap::complete_loaded_archive_space(MemRegion archive_space) {
+  // The archived objects are expected to live for the whole life of the VM. Pin the
+  // region that holds them, so that they are never copied during evacuation. The
+  // region will become pinned on the next sync_pinned_region_status().
+  ShenandoahHeapRegion* r = heap_region_containing(archive_space.start());
+  assert(r == heap_region_containing(archive_space.last()), "Archive space must be in a single region");
+  assert(r->is_regular(), "Archive space must be in regular region: " SIZE_FORMAT, r->index());
+  r->record_pin();
+
+  log_debug(gc, heap)("Pinned region " SIZE_FORMAT " for archived objects [" PTR_FORMAT ", " PTR_FORMAT ")",
+                      r->index(), p2i(archive_space.start()), p2i(archive_space.end()));
+}
+
+size_t ShenandoahHeap::max_loaded_archive_space_word_size() const {
+  // Anything larger would be allocated as a humongous object, which cannot
+  // hold more than one object
+  return ShenandoahHeapRegion::humongous_threshold_words();
+}
+
 MetaWord* ShenandoahHeap::satisfy_failed_metadata_allocation(ClassLoaderData* loader_data,
                                                              size_t size,
                                                              Metaspace::MetadataType mdtype) {
@@ -568,6 +568,15 @@ class ShenandoahHeap : public CollectedHeap, public ShenandoahSpaceInfo {
   void tlabs_retire(bool resize);
   void gclabs_retire(bool resize);
 
+// ---------- CDS archive support
+//
+public:
+  // Archived objects are loaded into regular regions, which are then pinned
+  bool can_load_archived_objects() const override { return true; }
+  HeapWord* allocate_loaded_archive_space(size_t size) override;
+  void complete_loaded_archive_space(MemRegion archive_space) override;
+  size_t max_loaded_archive_space_word_size() const override;
+
 // ---------- Marking support
 //
 private:
@@ -28,6 +28,7 @@
 #include "gc/shared/suspendibleThreadSet.hpp"
 #include "gc/z/zAbort.hpp"
 #include "gc/z/zAddress.inline.hpp"
+#include "gc/z/zAllocationFlags.hpp"
 #include "gc/z/zAllocator.inline.hpp"
 #include "gc/z/zCollectedHeap.hpp"
 #include "gc/z/zContinuation.inline.hpp"
@@ -39,14 +40,17 @@
 #include "gc/z/zJNICritical.hpp"
 #include "gc/z/zNMethod.hpp"
 #include "gc/z/zObjArrayAllocator.hpp"
+#include "gc/z/zPage.inline.hpp"
 #include "gc/z/zServiceability.hpp"
 #include "gc/z/zStackChunkGCData.inline.hpp"
 #include "gc/z/zStat.hpp"
 #include "gc/z/zUtils.inline.hpp"
+#include "logging/log.hpp"
 #include "memory/classLoaderMetaspace.hpp"
-#include "memory/iterator.hpp"
+#include "memory/iterator.inline.hpp"
 #include "memory/metaspaceCriticalAllocation.hpp"
 #include "memory/universe.hpp"
+#include "oops/oop.inline.hpp"
 #include "oops/stackChunkOop.hpp"
 #include "runtime/continuationJavaClasses.hpp"
 #include "runtime/jniHandles.inline.hpp"
@@ -282,6 +286,63 @@ void ZCollectedHeap::unpin_object(JavaThread* thread, oop obj) {
   ZJNICritical::exit(thread);
 }
 
+// The archived objects are placed densely into small pages in the old generation,
+// one page per block. From then on, they are marked and relocated like any other
+// old objects.
+HeapWord* ZCollectedHeap::allocate_loaded_archive_space(size_t size) {
+  const size_t size_in_bytes = ZUtils::words_to_bytes(size);
+  assert(size_in_bytes <= ZPageSizeSmall, "Invalid size");
+
+  // Allocation must not stall, since this is done during VM initialization
+  ZAllocationFlags flags;
+  flags.set_non_blocking();
+
+  ZPage* const page = _heap.alloc_page(ZPageType::small, ZPageSizeSmall, flags, ZPageAge::old);
+  if (page == nullptr) {
+    return nullptr;
+  }
+
+  const zaddress addr = page->alloc_object(size_in_bytes);
+  assert(!is_null(addr), "Should fit in page");
+
+  log_debug(gc, heap)("Archived objects page: " PTR_FORMAT " size: " SIZE_FORMAT,
+                      untype(addr), size_in_bytes);
+
+  return (HeapWord*)untype(addr);
+}
+
+class ZColorLoadedArchivePointersClosure : public BasicOopIterateClosure {
+public:
+  virtual void do_oop(oop* p) {
+    // ArchiveHeapLoader has relocated the field to a plain, uncolored address
+    const uintptr_t value = *(uintptr_t*)p;
+    if (value != 0) {
+      // Color the field load (and mark) good, but not store good. The field
+      // has no remembered set entry, so the first store into it must take the
+      // store barrier slow path, which remembers the field.
+      const zaddress addr = to_zaddress(value);
+      *(zpointer*)p = ZAddress::load_good(addr, ZAddress::store_good(addr));
+    }
+  }
+
+  virtual void do_oop(narrowOop* p) {
+    ShouldNotReachHere();
+  }
+};
+
+void ZCollectedHeap::complete_loaded_archive_space(MemRegion archive_space) {
+  ZColorLoadedArchivePointersClosure cl;
+  for (HeapWord* p = archive_space.start(); p < archive_space.end();) {
+    const oop obj = cast_to_oop(p);
+    obj->oop_iterate(&cl);
+    p += obj->size();
+  }
+}
+
+size_t ZCollectedHeap::max_loaded_archive_space_word_size() const {
+  return ZUtils::bytes_to_words(ZPageSizeSmall);
+}
+
 void ZCollectedHeap::keep_alive(oop obj) {
   _heap.keep_alive(obj);
 }
@@ -115,6 +115,12 @@ class ZCollectedHeap : public CollectedHeap {
   void pin_object(JavaThread* thread, oop obj) override;
   void unpin_object(JavaThread* thread, oop obj) override;
 
+  // Support for loading objects from CDS archive into the heap
+  bool can_load_archived_objects() const override { return true; }
+  HeapWord* allocate_loaded_archive_space(size_t size) override;
+  void complete_loaded_archive_space(MemRegion archive_space) override;
+  size_t max_loaded_archive_space_word_size() const override;
+
   void print_on(outputStream* st) const override;
   void print_on_error(outputStream* st) const override;
   void print_extended_on(outputStream* st) const override;
@@ -39,7 +39,7 @@
 #define CDS_ARCHIVE_MAGIC 0xf00baba2
 #define CDS_DYNAMIC_ARCHIVE_MAGIC 0xf00baba8
 #define CDS_GENERIC_HEADER_SUPPORTED_MIN_VERSION 13
-#define CURRENT_CDS_ARCHIVE_VERSION 18
+#define CURRENT_CDS_ARCHIVE_VERSION 21
 
 typedef struct CDSFileMapRegion {
   int     _crc;               // CRC checksum of this region.
@@ -70,6 +70,8 @@ typedef struct CDSFileMapRegion {
                               // (The base address is the bottom of the BM region).
   size_t  _ptrmap_size_in_bits;
   char*   _mapped_base;       // Actually mapped address (NULL if this region is not mapped).
+  size_t  _compressed_size;   // Number of bytes of this region in the archive file if it is compressed,
+                              // or 0 if the region is stored uncompressed and can be mapped.
 } CDSFileMapRegion;
 
 // This portion of the archive file header must remain unchanged for
@@ -27,6 +27,7 @@
 #include "cds/cdsConfig.hpp"
 #include "cds/classListWriter.hpp"
 #include "cds/heapShared.hpp"
+#include "cds/hotClassProfile.hpp"
 #include "cds/metaspaceShared.hpp"
 #include "classfile/classFileParser.hpp"
 #include "classfile/classFileStream.hpp"
@@ -1225,6 +1226,12 @@ void InstanceKlass::initialize_impl(TRAPS) {
   if (!HAS_PENDING_EXCEPTION) {
     set_initialization_state_and_notify(fully_initialized, THREAD);
     debug_only(vtable().verify(tty, true);)
+    if (HotClassProfile::is_recording()) {
+      HotClassProfile::record_initialized(this);
+    }
+    if (PrecompileTrainedMethods && is_shared()) {
+      CompilationPolicy::compile_trained_methods(this, THREAD);
+    }
   }
   else {
     // Step 10 and 11
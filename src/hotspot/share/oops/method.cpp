@@ -25,6 +25,7 @@
 #include "precompiled.hpp"
 #include "cds/cdsConfig.hpp"
 #include "cds/cppVtables.hpp"
+#include "cds/filemap.hpp"
 #include "cds/metaspaceShared.hpp"
 #include "classfile/classLoaderDataGraph.hpp"
 #include "classfile/metadataOnStackMark.hpp"
@@ -411,6 +412,23 @@ void Method::remove_unshareable_info() {
 void Method::restore_unshareable_info(TRAPS) {
   assert(is_method() && is_valid_method(this), "ensure C++ vtable is restored");
   assert(!queued_for_compilation(), "method's queued_for_compilation flag should not be set");
+
+  if (_method_data != nullptr || _method_counters != nullptr) {
+    // Only the dynamic archive may contain method profiles.
+    FileMapInfo* info = FileMapInfo::dynamic_info();
+    if (info != nullptr && MetaspaceShared::is_shared_dynamic(this) && info->header()->has_method_profiles()) {
+      methodHandle mh(THREAD, this);
+      if (_method_data != nullptr) {
+        _method_data->restore_unshareable_info();
+      }
+      if (_method_counters != nullptr) {
+        _method_counters->restore_unshareable_info(mh);
+      }
+    } else {
+      _method_data = nullptr;
+      _method_counters = nullptr;
+    }
+  }
 }
 #endif
 
@@ -1191,8 +1209,21 @@ void Method::unlink_method() {
   }
   NOT_PRODUCT(set_compiled_invocation_count(0);)
 
-  clear_method_data();
-  clear_method_counters();
+  if (CDSConfig::is_dumping_method_profiles()) {
+    // <this> is in the ArchiveBuilder's buffer, and so are its MethodData and MethodCounters.
+    MethodCounters* mcs = method_counters();
+    set_has_trained_code(method_data() != nullptr && mcs != nullptr &&
+                         mcs->highest_comp_level() == CompLevel_full_optimization);
+    if (method_data() != nullptr) {
+      method_data()->remove_unshareable_info();
+    }
+    if (method_counters() != nullptr) {
+      method_counters()->remove_unshareable_info();
+    }
+  } else {
+    clear_method_data();
+    clear_method_counters();
+  }
   remove_unshareable_flags();
 }
 
@@ -39,8 +39,11 @@ MethodCounters::MethodCounters(const methodHandle& mh) :
   JVMTI_ONLY(clear_number_of_breakpoints());
   invocation_counter()->init();
   backedge_counter()->init();
+  init_notify_masks(mh);
+}
 
-  // Set per-method thresholds.
+// Set per-method thresholds.
+void MethodCounters::init_notify_masks(const methodHandle& mh) {
   double scale = 1.0;
   CompilerOracle::has_option_value(mh, CompileCommandEnum::CompileThresholdScaling, scale);
 
@@ -69,6 +72,26 @@ void MethodCounters::clear_counters() {
   set_highest_osr_comp_level(0);
 }
 
+#if INCLUDE_CDS
+// Keep the invocation and backedge counts of the training run, so that the
+// compilation policy sees the method as warm right away. Everything that is
+// tied to the dumping JVM's timeline or its compiled code is reset.
+void MethodCounters::remove_unshareable_info() {
+  set_prev_time(0);
+  set_prev_event_count(0);
+  set_rate(0);
+  set_highest_comp_level(0);
+  set_highest_osr_comp_level(0);
+  set_interpreter_throwout_count(0);
+  JVMTI_ONLY(clear_number_of_breakpoints());
+}
+
+void MethodCounters::restore_unshareable_info(const methodHandle& mh) {
+  // The masks depend on the runtime flags and CompileCommands.
+  init_notify_masks(mh);
+}
+#endif // INCLUDE_CDS
+
 void MethodCounters::print_value_on(outputStream* st) const {
   assert(is_methodCounters(), "must be methodCounters");
   st->print("method counters");
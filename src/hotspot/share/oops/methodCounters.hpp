@@ -51,6 +51,13 @@ class MethodCounters : public Metadata {
   u1                _highest_osr_comp_level;      // Same for OSR level
 
   MethodCounters(const methodHandle& mh);
+  void init_notify_masks(const methodHandle& mh);
+
+  // Used by CDS. These classes need to access the private MethodCounters() constructor.
+  template <class T> friend class CppVtableTesterA;
+  template <class T> friend class CppVtableTesterB;
+  template <class T> friend class CppVtableCloner;
+  MethodCounters() {}
  public:
   virtual bool is_methodCounters() const { return true; }
 
@@ -68,6 +75,11 @@ class MethodCounters : public Metadata {
   MetaspaceObj::Type type() const { return MethodCountersType; }
   void clear_counters();
 
+#if INCLUDE_CDS
+  void remove_unshareable_info();
+  void restore_unshareable_info(const methodHandle& mh);
+#endif
+
 #if COMPILER2_OR_JVMCI
   void interpreter_throwout_increment() {
     if (_interpreter_throwout_count < 65534) {
@@ -1316,12 +1316,8 @@ void MethodData::init() {
   _invocation_counter_start = 0;
   _backedge_counter_start = 0;
 
-  // Set per-method invoke- and backedge mask.
-  double scale = 1.0;
   methodHandle mh(Thread::current(), _method);
-  CompilerOracle::has_option_value(mh, CompileCommandEnum::CompileThresholdScaling, scale);
-  _invoke_mask = (int)right_n_bits(CompilerConfig::scaled_freq_log(Tier0InvokeNotifyFreqLog, scale)) << InvocationCounter::count_shift;
-  _backedge_mask = (int)right_n_bits(CompilerConfig::scaled_freq_log(Tier0BackedgeNotifyFreqLog, scale)) << InvocationCounter::count_shift;
+  init_notify_masks(mh);
 
   _tenure_traps = 0;
   _num_loops = 0;
@@ -1352,6 +1348,14 @@ void MethodData::init() {
   clear_escape_info();
 }
 
+// Set per-method invoke- and backedge mask.
+void MethodData::init_notify_masks(const methodHandle& mh) {
+  double scale = 1.0;
+  CompilerOracle::has_option_value(mh, CompileCommandEnum::CompileThresholdScaling, scale);
+  _invoke_mask = (int)right_n_bits(CompilerConfig::scaled_freq_log(Tier0InvokeNotifyFreqLog, scale)) << InvocationCounter::count_shift;
+  _backedge_mask = (int)right_n_bits(CompilerConfig::scaled_freq_log(Tier0BackedgeNotifyFreqLog, scale)) << InvocationCounter::count_shift;
+}
+
 // Get a measure of how much mileage the method has on it.
 int MethodData::mileage_of(Method* method) {
   return MAX2(method->invocation_count(), method->backedge_count());
@@ -1874,6 +1878,45 @@ void MethodData::deallocate_contents(ClassLoaderData* loader_data) {
   release_C_heap_structures();
 }
 
+#if INCLUDE_CDS
+unsigned int MethodData::layout_fingerprint() {
+  unsigned int hash = 1;
+  auto mix = [&](intx v) { hash = 31 * hash + (unsigned int)v; };
+  mix(TypeProfileWidth);
+  mix(BciProfileWidth);
+  mix(TypeProfileLevel);
+  mix(TypeProfileArgsLimit);
+  mix(TypeProfileParmsLimit);
+  mix(TypeProfileCasts);
+  mix(ProfileTraps);
+  mix(ProfileExceptionHandlers);
+  JVMCI_ONLY(mix(EnableJVMCI);)
+  return hash == 0 ? 1 : hash;
+}
+
+// <this> is the copy to be written into the archive. It's in the ArchiveBuilder's
+// "buffer space". The counters are kept, but the receiver and argument type
+// profiles are cleared: the recorded Klasses may not be loaded when the archived
+// profile is used.
+void MethodData::remove_unshareable_info() {
+  // _extra_data_lock is a bitwise copy of the lock of the source MethodData. Give
+  // the copy a lock of its own while cleaning, and don't leave any of it in the archive.
+  ::new ((void*)&_extra_data_lock) Mutex(Mutex::nosafepoint, "MDOExtraData_lock");
+  clean_method_data(/*always_clean*/true);
+  _extra_data_lock.~Mutex();
+  memset((void*)&_extra_data_lock, 0, sizeof(_extra_data_lock));
+
+  _hint_di = first_di();
+  JVMCI_ONLY(_failed_speculations = nullptr;)
+}
+
+void MethodData::restore_unshareable_info() {
+  ::new ((void*)&_extra_data_lock) Mutex(Mutex::nosafepoint, "MDOExtraData_lock");
+  methodHandle mh(Thread::current(), _method);
+  init_notify_masks(mh);
+}
+#endif // INCLUDE_CDS
+
 void MethodData::release_C_heap_structures() {
 #if INCLUDE_JVMCI
   FailedSpeculation::free_failed_speculations(get_failed_speculations_address());
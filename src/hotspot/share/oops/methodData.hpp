@@ -1966,6 +1966,12 @@ class MethodData : public Metadata {
   Mutex _extra_data_lock;
 
   MethodData(const methodHandle& method);
+
+  // Used by CDS. These classes need to access the private MethodData() constructor.
+  template <class T> friend class CppVtableTesterA;
+  template <class T> friend class CppVtableTesterB;
+  template <class T> friend class CppVtableCloner;
+  MethodData() : _extra_data_lock(Mutex::nosafepoint, "MDOExtraData_lock") {}
 public:
   static MethodData* allocate(ClassLoaderData* loader_data, const methodHandle& method, TRAPS);
 
@@ -2218,6 +2224,7 @@ class MethodData : public Metadata {
 
   // reset into original state
   void init();
+  void init_notify_masks(const methodHandle& mh);
 
   // My size
   int size_in_bytes() const { return _size; }
@@ -2500,6 +2507,14 @@ class MethodData : public Metadata {
   void deallocate_contents(ClassLoaderData* loader_data);
   void release_C_heap_structures();
 
+#if INCLUDE_CDS
+  // The layout of a MethodData depends on these flags. An archived MethodData can
+  // be used only if this returns the same value at dump time and at runtime.
+  static unsigned int layout_fingerprint();
+  void remove_unshareable_info();
+  void restore_unshareable_info();
+#endif
+
   // GC support
   void set_size(int object_size_in_bytes) { _size = object_size_in_bytes; }
 
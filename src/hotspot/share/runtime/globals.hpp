@@ -1541,6 +1541,17 @@ const int ObjectAlignmentInBytes = 8;
           "Size of code heap with non-nmethods (in bytes)")                 \
           constraint(VMPageSizeConstraintFunc, AtParse)                     \
                                                                             \
+  product(uintx, HotCodeHeapSize, 0, EXPERIMENTAL,                          \
+          "Size of the code heap for hot non-profiled methods (in bytes), " \
+          "taken from the non-profiled code heap. 0 disables the heap")     \
+          range(0, max_uintx)                                               \
+                                                                            \
+  product(intx, HotCodeMinRate, 100, EXPERIMENTAL,                          \
+          "Minimum event rate (invocations and backedges per millisecond) " \
+          "of a method at C2 compilation for its code to be placed in "     \
+          "the hot code heap")                                              \
+          range(0, max_jint)                                                \
+                                                                            \
   product_pd(uintx, CodeCacheExpansionSize,                                 \
           "Code cache expansion size (in bytes)")                           \
           range(32*K, max_uintx)                                            \
@@ -1566,6 +1577,11 @@ const int ObjectAlignmentInBytes = 8;
           "Non-segmented code cache: X[%] of the total code cache")         \
           range(0, 100)                                                     \
                                                                             \
+  product(bool, HotnessBasedCodeCacheFlushing, false, EXPERIMENTAL,         \
+          "Keep hot nmethods longer than other unused nmethods, and when "  \
+          "the code cache is full, unload cold code instead of stopping "   \
+          "compilation. Requires UseCodeCacheFlushing")                     \
+                                                                            \
   /* interpreter debugging */                                               \
   develop(intx, BinarySwitchThreshold, 5,                                   \
           "Minimal number of lookupswitch entries for rewriting to binary " \
@@ -23,6 +23,9 @@
  */
 
 #include "precompiled.hpp"
+#include "cds/archiveBuilder.hpp"
+#include "cds/archiveUtils.hpp"
+#include "cds/cdsConfig.hpp"
 #include "classfile/javaClasses.inline.hpp"
 #include "classfile/stringTable.hpp"
 #include "classfile/vmClasses.hpp"
@@ -46,6 +49,7 @@
 #include "memory/resourceArea.hpp"
 #include "memory/universe.hpp"
 #include "metaprogramming/primitiveConversions.hpp"
+#include "oops/array.hpp"
 #include "oops/klass.hpp"
 #include "oops/method.inline.hpp"
 #include "oops/objArrayKlass.hpp"
@@ -2272,6 +2276,61 @@ class AdapterFingerPrint : public CHeapObj<mtCode> {
   }
 #endif // !product
 
+  // Reconstitutes a signature that has this fingerprint from the packed
+  // values. The adapters of all such signatures are equivalent.
+  // Returns the number of BasicTypes stored into sig_bt, or -1 if it
+  // would exceed max_args.
+  static int decode(const int* values, int length, BasicType* sig_bt, int max_args) {
+    int n = 0;
+    bool long_prev = false;
+    auto put = [&] (BasicType bt) {
+      if (n < max_args) {
+        sig_bt[n] = bt;
+      }
+      n++;
+    };
+    for (int i = 0; i < length; i++) {
+      unsigned val = (unsigned)values[i];
+      for (int j = 32 - _basic_type_bits; j >= 0; j -= _basic_type_bits) {
+        unsigned v = (val >> j) & _basic_type_mask;
+        if (v == 0) {
+          continue;
+        }
+        if (long_prev) {
+          // A long is followed by its T_VOID half, an object is not.
+          long_prev = false;
+          if (v == T_VOID) {
+            put(T_LONG);
+            put(T_VOID);
+            continue;
+          }
+          put(T_OBJECT);
+        }
+        if (v == T_LONG) {
+          long_prev = true;
+        } else {
+          put((BasicType)v);
+        }
+      }
+    }
+    if (long_prev) {
+      put(T_OBJECT);
+    }
+    return n <= max_args ? n : -1;
+  }
+
+  bool has_values(const int* values, int length) {
+    if (this->length() != length) {
+      return false;
+    }
+    for (int i = 0; i < length; i++) {
+      if (value(i) != values[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   bool equals(AdapterFingerPrint* other) {
     if (other->_length != _length) {
       return false;
@@ -2348,6 +2407,9 @@ AdapterHandlerEntry* AdapterHandlerLibrary::_obj_int_arg_handler = nullptr;
 AdapterHandlerEntry* AdapterHandlerLibrary::_obj_obj_arg_handler = nullptr;
 const int AdapterHandlerLibrary_size = 16*K;
 BufferBlob* AdapterHandlerLibrary::_buffer = nullptr;
+#if INCLUDE_CDS
+Array<int>* AdapterHandlerLibrary::_archived_fingerprints = nullptr;
+#endif
 
 BufferBlob* AdapterHandlerLibrary::buffer_blob() {
   return _buffer;
@@ -2421,6 +2483,8 @@ void AdapterHandlerLibrary::initialize() {
   post_adapter_creation(int_arg_blob, _int_arg_handler);
   post_adapter_creation(obj_int_arg_blob, _obj_int_arg_handler);
   post_adapter_creation(obj_obj_arg_blob, _obj_obj_arg_handler);
+
+  create_archived_adapters();
 }
 
 AdapterHandlerEntry* AdapterHandlerLibrary::new_entry(AdapterFingerPrint* fingerprint,
@@ -2645,6 +2709,156 @@ AdapterHandlerEntry* AdapterHandlerLibrary::create_adapter(AdapterBlob*& new_ada
   return entry;
 }
 
+#if INCLUDE_CDS
+// The archived methods are linked, and so get their adapters, when the static archive
+// is dumped. Record the fingerprints of all adapters in the table at that point as
+// [length, value(0), ..., value(length-1)]*.
+void AdapterHandlerLibrary::archive_adapter_fingerprints() {
+  assert(CDSConfig::is_dumping_static_archive(), "sanity");
+  MutexLocker mu(AdapterHandlerLibrary_lock);
+  int total = 0;
+  auto count = [&] (AdapterFingerPrint* fp, AdapterHandlerEntry* a) {
+    total += 1 + fp->length();
+  };
+  _adapter_handler_table->iterate_all(count);
+  if (total == 0) {
+    return;
+  }
+
+  _archived_fingerprints = ArchiveBuilder::new_ro_array<int>(total);
+  int pos = 0;
+  int num = 0;
+  auto store = [&] (AdapterFingerPrint* fp, AdapterHandlerEntry* a) {
+    _archived_fingerprints->at_put(pos++, fp->length());
+    for (int i = 0; i < fp->length(); i++) {
+      _archived_fingerprints->at_put(pos++, fp->value(i));
+    }
+    num++;
+  };
+  _adapter_handler_table->iterate_all(store);
+  assert(pos == total, "must be");
+  log_info(cds)("Archived %d adapter fingerprints", num);
+}
+
+void AdapterHandlerLibrary::serialize_shared_table_header(SerializeClosure* soc) {
+  soc->do_ptr(&_archived_fingerprints);
+}
+
+// Create the adapters for the fingerprints in the static archive. The methods of the
+// archived classes will need almost all of them during startup. Generating them up
+// front packs many adapters into each AdapterBlob, so linking an archived class
+// seldom needs to allocate in the CodeCache or publish a new code blob.
+void AdapterHandlerLibrary::create_archived_adapters() {
+  if (!PregenerateArchivedAdapters || _archived_fingerprints == nullptr) {
+    return;
+  }
+  if (VerifyAdapterCalls || VerifyAdapterSharing) {
+    // The adapters with all the verification code can be generated only after the final stubs.
+    return;
+  }
+
+  const int max_batch = 64;
+  const int max_locs_per_adapter = 20;
+  const int max_args = 256;
+  // The adapters are generated into the shared buffer, which cannot grow. Only start
+  // an adapter if there is room for the largest adapter generated so far plus a
+  // generous allowance per argument, and check that it did fit afterwards.
+  int largest_adapter = 0;
+  auto size_estimate = [&] (int total_args_passed) {
+    return MAX2(largest_adapter, (int)K) + total_args_passed * 128;
+  };
+
+  Array<int>* values = _archived_fingerprints;
+  int pos = 0;
+  int created = 0;
+  int blobs = 0;
+  while (pos < values->length()) {
+    ResourceMark rm;
+    AdapterHandlerEntry* batch[max_batch];
+    int batch_size = 0;
+    AdapterBlob* blob = nullptr;
+    {
+      MutexLocker mu(AdapterHandlerLibrary_lock);
+      CodeBuffer buffer(buffer_blob());
+      relocInfo* locs = NEW_RESOURCE_ARRAY(relocInfo, max_batch * max_locs_per_adapter);
+      buffer.insts()->initialize_shared_locs(locs, max_batch * max_locs_per_adapter);
+      MacroAssembler masm(&buffer);
+
+      while (pos < values->length() && batch_size < max_batch) {
+        int length = values->at(pos);
+        const int* fp_values = (length > 0) ? values->adr_at(pos + 1) : nullptr;
+
+        BasicType sig_bt[max_args];
+        int total_args_passed = AdapterFingerPrint::decode(fp_values, length, sig_bt, max_args);
+        if (total_args_passed > 0 && size_estimate(total_args_passed) > buffer.insts_remaining()) {
+          if (batch_size > 0) {
+            break; // Start a new blob with this one.
+          }
+          // Too large for a batch. get_adapter() will create it if it's ever needed.
+          total_args_passed = -1;
+        }
+        pos += 1 + length;
+        if (total_args_passed <= 0) {
+          continue; // The no-arg adapter is created by initialize().
+        }
+        AdapterFingerPrint* fingerprint = new AdapterFingerPrint(total_args_passed, sig_bt);
+        if (!fingerprint->has_values(fp_values, length) ||
+            _adapter_handler_table->get(fingerprint) != nullptr) {
+          // Fingerprints from an archive dumped with different encodings, or adapters that already exist.
+          delete fingerprint;
+          continue;
+        }
+
+        VMRegPair regs[max_args];
+        int comp_args_on_stack = SharedRuntime::java_calling_convention(sig_bt, regs, total_args_passed);
+        address adapter_begin = buffer.insts_end();
+        batch[batch_size++] = SharedRuntime::generate_i2c2i_adapters(&masm, total_args_passed, comp_args_on_stack,
+                                                                     sig_bt, regs, fingerprint);
+        guarantee(buffer.insts_remaining() >= 0, "adapter overflowed the buffer: %d args", total_args_passed);
+        largest_adapter = MAX2(largest_adapter, (int)(buffer.insts_end() - adapter_begin));
+      }
+
+      if (batch_size == 0) {
+        continue;
+      }
+      blob = AdapterBlob::create(&buffer);
+      if (blob == nullptr) {
+        // CodeCache is full. Leave the rest to get_adapter().
+        for (int i = 0; i < batch_size; i++) {
+          delete batch[i];
+        }
+        return;
+      }
+      for (int i = 0; i < batch_size; i++) {
+        AdapterHandlerEntry* entry = batch[i];
+        entry->relocate(blob->content_begin() + (entry->base_address() - buffer.insts_begin()));
+        _adapter_handler_table->put(entry->fingerprint(), entry);
+#ifndef PRODUCT
+        if (PrintAdapterHandlers) {
+          ttyLocker ttyl;
+          entry->print_adapter_on(tty);
+        }
+#endif
+      }
+    }
+
+    // Outside of the lock
+    if (Forte::is_enabled() || JvmtiExport::should_post_dynamic_code_generated()) {
+      const char* blob_id = "AdapterBlob(archived fingerprints)";
+      if (Forte::is_enabled()) {
+        Forte::register_stub(blob_id, blob->content_begin(), blob->content_end());
+      }
+      if (JvmtiExport::should_post_dynamic_code_generated()) {
+        JvmtiExport::post_dynamic_code_generated(blob_id, blob->content_begin(), blob->content_end());
+      }
+    }
+    created += batch_size;
+    blobs++;
+  }
+  log_info(cds)("Created %d archived adapters in %d code blobs", created, blobs);
+}
+#endif // INCLUDE_CDS
+
 address AdapterHandlerEntry::base_address() {
   address base = _i2c_entry;
   if (base == nullptr)  base = _c2i_entry;
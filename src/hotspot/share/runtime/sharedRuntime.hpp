@@ -34,6 +34,8 @@
 
 class AdapterHandlerEntry;
 class AdapterFingerPrint;
+class SerializeClosure;
+template <typename T> class Array;
 class vframeStream;
 
 // Runtime is the base class for various runtime interfaces
@@ -681,9 +683,14 @@ class AdapterHandlerLibrary: public AllStatic {
   static AdapterHandlerEntry* _obj_arg_handler;
   static AdapterHandlerEntry* _obj_int_arg_handler;
   static AdapterHandlerEntry* _obj_obj_arg_handler;
+#if INCLUDE_CDS
+  // The fingerprints of the adapters created while dumping the static archive.
+  static Array<int>* _archived_fingerprints;
+#endif
 
   static BufferBlob* buffer_blob();
   static void initialize();
+  static void create_archived_adapters() NOT_CDS_RETURN;
   static AdapterHandlerEntry* create_adapter(AdapterBlob*& new_adapter,
                                              int total_args_passed,
                                              BasicType* sig_bt,
@@ -699,6 +706,11 @@ class AdapterHandlerLibrary: public AllStatic {
   static void create_native_wrapper(const methodHandle& method);
   static AdapterHandlerEntry* get_adapter(const methodHandle& method);
 
+#if INCLUDE_CDS
+  static void archive_adapter_fingerprints();
+  static void serialize_shared_table_header(SerializeClosure* soc);
+#endif
+
   static void print_handler(const CodeBlob* b) { print_handler_on(tty, b); }
   static void print_handler_on(outputStream* st, const CodeBlob* b);
   static bool contains(const CodeBlob* b);
@@ -24,6 +24,7 @@
 
 #include "precompiled.hpp"
 #include "cds/classListWriter.hpp"
+#include "cds/hotClassProfile.hpp"
 #include "compiler/compileLog.hpp"
 #include "jvm.h"
 #include "memory/allocation.inline.hpp"
@@ -938,6 +939,7 @@ void ostream_init_log() {
   // Note : this must be called AFTER ostream_init()
 
   ClassListWriter::init();
+  HotClassProfile::init();
 
   // If we haven't lazily initialized the logfile yet, do it now,
   // to avoid the possibility of lazy initialization during a VM
@@ -952,6 +954,7 @@ void ostream_exit() {
   if (ostream_exit_called)  return;
   ostream_exit_called = true;
   ClassListWriter::delete_classlist();
+  HotClassProfile::close();
   // Make sure tty works after VM exit by assigning an always-on functioning fdStream.
   outputStream* tmp = tty;
   tty = DisplayVMOutputToStderr ? fdStream::stdout_stream() : fdStream::stderr_stream();
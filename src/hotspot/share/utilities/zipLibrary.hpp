@@ -49,6 +49,7 @@ class ZipLibrary : AllStatic {
   static jint crc32(jint crc, const jbyte* buf, jint len);
   static const char* init_params(size_t block_size, size_t* needed_out_size, size_t* needed_tmp_size, int level);
   static size_t compress(char* in, size_t in_size, char* out, size_t out_size, char* tmp, size_t tmp_size, int level, char* buf, const char** pmsg);
+  static bool decompress(char* in, size_t in_size, char* out, size_t out_size, const char** pmsg);
   static void* handle();
 };
 
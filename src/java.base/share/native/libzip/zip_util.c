@@ -1692,3 +1692,37 @@ ZIP_GZip_Fully(char* inBuf, size_t inLen, char* outBuf, size_t outLen, char* tmp
 
   return result;
 }
+
+/*
+ * Inflates the gzip stream produced by ZIP_GZip_Fully from inBuf into outBuf,
+ * which must be exactly large enough for the uncompressed data.
+ */
+JNIEXPORT jboolean
+ZIP_GZip_InflateFully(char* inBuf, size_t inLen, char* outBuf, size_t outLen, char const** pmsg)
+{
+    z_stream strm;
+    int err;
+    memset(&strm, 0, sizeof(z_stream));
+
+    *pmsg = NULL; /* Reset error message */
+
+    if (inflateInit2(&strm, 31) != Z_OK) {
+        *pmsg = "Internal error in inflateInit2";
+        return JNI_FALSE;
+    }
+
+    strm.next_out = (Bytef *) outBuf;
+    strm.avail_out = (uInt) outLen;
+    strm.next_in = (Bytef *) inBuf;
+    strm.avail_in = (uInt) inLen;
+
+    err = inflate(&strm, Z_FINISH);
+    if (err != Z_STREAM_END) {
+        *pmsg = (err == Z_DATA_ERROR) ? "Compressed data corrupted" : "Intern inflate error";
+    } else if (strm.total_out != (uLong) outLen) {
+        *pmsg = "Unexpected end of stream";
+    }
+
+    inflateEnd(&strm);
+    return *pmsg == NULL ? JNI_TRUE : JNI_FALSE;
+}
@@ -388,7 +388,8 @@ bool init_classsharing_workaround(struct ps_prochandle* ph) {
       for (m = 0; m < NUM_CDS_REGIONS; m++) {
         if (header._regions[m]._read_only &&
             !header._regions[m]._is_heap_region &&
-            !header._regions[m]._is_bitmap_region) {
+            !header._regions[m]._is_bitmap_region &&
+            header._regions[m]._compressed_size == 0) {
           // With *some* linux versions, the core file doesn't include read-only mmap'ed
           // files regions, so let's add them here. This is harmless if the core file also
           // include these regions.
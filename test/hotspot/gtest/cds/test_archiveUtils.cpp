@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "utilities/macros.hpp"
+
+#if INCLUDE_CDS
+
+#include "cds/archiveUtils.hpp"
+#include "classfile/classLoader.hpp"
+#include "unittest.hpp"
+
+static const size_t buffer_size = 10000;
+
+static void fill_buffer(char* buf, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    buf[i] = (char)(i * 31 + (i >> 7));
+  }
+}
+
+TEST_VM(ArchiveUtils, crc32_combine) {
+  char* buf = NEW_C_HEAP_ARRAY(char, buffer_size, mtTest);
+  fill_buffer(buf, buffer_size);
+  const int expected = ClassLoader::crc32(0, buf, (jint)buffer_size);
+
+  const size_t splits[] = { 0, 1, 7, 4096, 4097, buffer_size - 1, buffer_size };
+  for (size_t split : splits) {
+    int crc1 = ClassLoader::crc32(0, buf, (jint)split);
+    int crc2 = ClassLoader::crc32(0, buf + split, (jint)(buffer_size - split));
+    EXPECT_EQ(expected, ArchiveUtils::crc32_combine(crc1, crc2, buffer_size - split))
+      << "split at " << split;
+  }
+
+  FREE_C_HEAP_ARRAY(char, buf);
+}
+
+TEST_VM(ArchiveUtils, crc32_combine_chunks) {
+  char* buf = NEW_C_HEAP_ARRAY(char, buffer_size, mtTest);
+  fill_buffer(buf, buffer_size);
+  const int expected = ClassLoader::crc32(0, buf, (jint)buffer_size);
+
+  const size_t chunk_size = 1000;
+  int crc = 0;
+  for (size_t offset = 0; offset < buffer_size; offset += chunk_size) {
+    size_t size = MIN2(chunk_size, buffer_size - offset);
+    crc = ArchiveUtils::crc32_combine(crc, ClassLoader::crc32(0, buf + offset, (jint)size), size);
+  }
+  EXPECT_EQ(expected, crc);
+
+  FREE_C_HEAP_ARRAY(char, buf);
+}
+
+#endif // INCLUDE_CDS
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2024, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "compiler/compileTaskHeap.hpp"
+#include "runtime/os.hpp"
+#include "unittest.hpp"
+
+// The tasks are never initialized for a method; only the fields compared by
+// CompileTask::has_higher_priority_than() and the heap index are set.
+class CompileTaskHeapTest : public ::testing::Test {
+ protected:
+  static const int NumTasks = 64;
+
+  CompileTask* _tasks[NumTasks];
+  CompileTaskHeap _heap;
+
+  CompileTaskHeapTest() : _heap() {
+    for (int i = 0; i < NumTasks; i++) {
+      CompileTask* task = new CompileTask();
+      task->_compile_id = i;
+      task->_is_blocking = false;
+      task->_estimated_cost = 1;
+      task->_queue_index = -1;
+      task->set_priority(0, 0.0, 0);
+      _tasks[i] = task;
+    }
+  }
+
+  ~CompileTaskHeapTest() {
+    for (int i = 0; i < NumTasks; i++) {
+      delete _tasks[i]->_lock;
+      delete _tasks[i];
+    }
+  }
+
+  static void set_blocking(CompileTask* task, bool value) {
+    task->_is_blocking = value;
+  }
+
+  static void set_estimated_cost(CompileTask* task, jlong cost) {
+    task->_estimated_cost = cost;
+  }
+
+  static bool is_queued(const CompileTask* task) {
+    return task->queue_index() >= 0;
+  }
+
+  // Every queued task must know its position, no task may have a higher
+  // priority than its parent, and the first task must beat all others.
+  void verify() const {
+    int queued = 0;
+    for (int i = 0; i < NumTasks; i++) {
+      if (is_queued(_tasks[i])) {
+        queued++;
+        ASSERT_LT(_tasks[i]->queue_index(), _heap.length());
+        ASSERT_EQ(_tasks[i], _heap.at(_tasks[i]->queue_index()));
+      }
+    }
+    ASSERT_EQ(queued, _heap.length());
+    for (int i = 0; i < _heap.length(); i++) {
+      ASSERT_EQ(i, _heap.at(i)->queue_index());
+      if (i > 0) {
+        ASSERT_FALSE(_heap.at(i)->has_higher_priority_than(_heap.at((i - 1) / 2))) << "at " << i;
+      }
+    }
+    for (int i = 0; i < NumTasks; i++) {
+      if (is_queued(_tasks[i]) && _tasks[i] != _heap.first()) {
+        ASSERT_TRUE(_heap.first()->has_higher_priority_than(_tasks[i]));
+      }
+    }
+  }
+
+  CompileTask* pop() {
+    CompileTask* task = _heap.first();
+    if (task != nullptr) {
+      _heap.remove(task);
+    }
+    return task;
+  }
+
+  // Few distinct values, so that there are many ties.
+  static void randomize_priority(CompileTask* task) {
+    task->set_priority(os::random() % 3, (double)(os::random() % 3), 0);
+  }
+};
+
+TEST_VM_F(CompileTaskHeapTest, random_operations) {
+  for (int i = 0; i < NumTasks; i++) {
+    set_blocking(_tasks[i], os::random() % 8 == 0);
+    set_estimated_cost(_tasks[i], os::random() % 3);
+    randomize_priority(_tasks[i]);
+  }
+  for (int step = 0; step < 5000; step++) {
+    CompileTask* task = _tasks[os::random() % NumTasks];
+    switch (os::random() % 4) {
+      case 0:
+        if (!is_queued(task)) {
+          _heap.add(task);
+        }
+        break;
+      case 1:
+        if (is_queued(task)) {
+          _heap.remove(task);
+        }
+        break;
+      case 2:
+        if (is_queued(task)) {
+          randomize_priority(task);
+          _heap.update(task);
+        }
+        break;
+      case 3:
+        if (os::random() % 16 == 0) {
+          for (int i = 0; i < NumTasks; i++) {
+            if (is_queued(_tasks[i])) {
+              randomize_priority(_tasks[i]);
+            }
+          }
+          _heap.rebuild();
+        }
+        break;
+    }
+    ASSERT_NO_FATAL_FAILURE(verify()) << "step " << step;
+  }
+  while (pop() != nullptr) {
+    ASSERT_NO_FATAL_FAILURE(verify());
+  }
+  ASSERT_TRUE(_heap.is_empty());
+}
+
+TEST_VM_F(CompileTaskHeapTest, blocking_first) {
+  for (int i = 0; i < NumTasks; i++) {
+    bool blocking = (i % 5 == 0);
+    set_blocking(_tasks[i], blocking);
+    // Blocking tasks have the lowest level, weight and the highest cost.
+    if (blocking) {
+      _tasks[i]->set_priority(0, 0.0, 0);
+      set_estimated_cost(_tasks[i], 1000);
+    } else {
+      _tasks[i]->set_priority(4, 100.0 + i, 0);
+      set_estimated_cost(_tasks[i], 1);
+    }
+    _heap.add(_tasks[i]);
+  }
+  ASSERT_NO_FATAL_FAILURE(verify());
+
+  bool seen_non_blocking = false;
+  for (CompileTask* task = pop(); task != nullptr; task = pop()) {
+    if (task->is_blocking()) {
+      ASSERT_FALSE(seen_non_blocking) << "blocking task " << task->compile_id() << " came late";
+    } else {
+      seen_non_blocking = true;
+    }
+    ASSERT_NO_FATAL_FAILURE(verify());
+  }
+}
+
+TEST_VM_F(CompileTaskHeapTest, fifo_on_ties) {
+  // Add the tasks, all with the same priority, in a shuffled order.
+  int order[NumTasks];
+  for (int i = 0; i < NumTasks; i++) {
+    order[i] = i;
+  }
+  for (int i = NumTasks - 1; i > 0; i--) {
+    int j = os::random() % (i + 1);
+    int tmp = order[i];
+    order[i] = order[j];
+    order[j] = tmp;
+  }
+  for (int i = 0; i < NumTasks; i++) {
+    _heap.add(_tasks[order[i]]);
+  }
+  ASSERT_NO_FATAL_FAILURE(verify());
+
+  // Update some of them without changing their priority.
+  for (int i = 0; i < NumTasks; i += 3) {
+    _heap.update(_tasks[i]);
+  }
+  _heap.rebuild();
+  ASSERT_NO_FATAL_FAILURE(verify());
+
+  for (int i = 0; i < NumTasks; i++) {
+    CompileTask* task = pop();
+    ASSERT_NE((CompileTask*)nullptr, task);
+    ASSERT_EQ(i, task->compile_id());
+  }
+  ASSERT_EQ((CompileTask*)nullptr, pop());
+}
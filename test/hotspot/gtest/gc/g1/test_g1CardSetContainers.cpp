@@ -76,6 +76,12 @@ class G1FindCardsInRange : public StackObj {
     ASSERT_FALSE(_cards_found[card - _range_min]); // Must not have been found yet.
     _cards_found[card - _range_min] = true;
   }
+
+  void operator()(uint card, uint length) {
+    for (uint i = 0; i < length; i++) {
+      (*this)(card + i);
+    }
+  }
 };
 
 void G1CardSetContainersTest::cardset_inlineptr_test(uint bits_per_card) {
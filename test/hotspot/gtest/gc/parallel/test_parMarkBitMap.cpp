@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2024, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/parallel/parMarkBitMap.inline.hpp"
+#include "gc/parallel/psVirtualspace.hpp"
+#include "memory/allocation.hpp"
+#include "runtime/os.hpp"
+#include "unittest.hpp"
+
+// A mark bitmap covering a small private range of heap words. The objects
+// are only recorded in the bitmap; the heap words are never accessed. All
+// positions and sizes are in bitmap bits, i.e. units of MinObjAlignment.
+class ParMarkBitMapTest : public ::testing::Test {
+ protected:
+  static const size_t RegionBits = 1024;
+
+  HeapWord* _region;
+  ParMarkBitMap _map;
+
+  ParMarkBitMapTest() :
+    _region(NEW_C_HEAP_ARRAY(HeapWord, RegionBits * MinObjAlignment, mtTest)),
+    _map() {}
+
+  void SetUp() override {
+    ASSERT_TRUE(_map.initialize(MemRegion(_region, RegionBits * MinObjAlignment)));
+  }
+
+  void TearDown() override {
+    if (_map._virtual_space != nullptr) {
+      char* base = _map._virtual_space->reserved_low_addr();
+      delete _map._virtual_space;
+      _map._virtual_space = nullptr;
+      os::release_memory(base, _map._reserved_byte_size);
+    }
+  }
+
+  ~ParMarkBitMapTest() {
+    FREE_C_HEAP_ARRAY(HeapWord, _region);
+  }
+
+  HeapWord* addr(size_t bit) const {
+    return _region + bit * MinObjAlignment;
+  }
+
+  void mark(size_t beg, size_t size) {
+    ASSERT_TRUE(_map.mark_obj(addr(beg), size * MinObjAlignment));
+  }
+
+  // The number of live words from objects starting in [beg, end_obj).
+  size_t live_words(size_t beg, size_t end_obj) const {
+    return _map.live_words_in_range_helper(addr(beg), cast_to_oop(addr(end_obj)));
+  }
+
+  static size_t words(size_t bits) {
+    return bits * MinObjAlignment;
+  }
+};
+
+TEST_VM_F(ParMarkBitMapTest, live_words_crossing_one_word) {
+  mark(60, 10);
+  mark(100, 1);
+  EXPECT_EQ(words(10), live_words(0, 100));
+  EXPECT_EQ(words(10), live_words(60, 100));
+}
+
+TEST_VM_F(ParMarkBitMapTest, live_words_crossing_several_words) {
+  mark(10, 200);
+  mark(230, 70);
+  mark(320, 1);
+  EXPECT_EQ(words(270), live_words(0, 320));
+  EXPECT_EQ(words(70), live_words(211, 320));
+}
+
+TEST_VM_F(ParMarkBitMapTest, live_words_single_bit_objects) {
+  // Begin and end bits coincide, including at both sides of a word boundary.
+  mark(5, 1);
+  mark(7, 1);
+  mark(8, 1);
+  mark(63, 1);
+  mark(64, 1);
+  mark(100, 2);
+  mark(140, 1);
+  EXPECT_EQ(words(7), live_words(0, 140));
+  EXPECT_EQ(words(5), live_words(8, 140));
+  EXPECT_EQ(words(3), live_words(64, 140));
+}
+
+TEST_VM_F(ParMarkBitMapTest, live_words_end_word_aligned) {
+  // The end object starts at bit 0 of a word, so end_offset is 0.
+  mark(0, 64);
+  mark(100, 28);
+  mark(128, 5);
+  mark(256, 1);
+  EXPECT_EQ(words(92), live_words(0, 128));
+  EXPECT_EQ(words(97), live_words(0, 256));
+  EXPECT_EQ(words(5), live_words(128, 256));
+}
+
+TEST_VM_F(ParMarkBitMapTest, live_words_begin_inside_object) {
+  // Objects that start before the range do not count.
+  mark(10, 100);
+  mark(120, 5);
+  mark(200, 1);
+  EXPECT_EQ(words(5), live_words(30, 200));
+  EXPECT_EQ(words(5), live_words(64, 200));
+  EXPECT_EQ(words(5), live_words(109, 200));
+  EXPECT_EQ(words(0), live_words(121, 200));
+}
+
+TEST_VM_F(ParMarkBitMapTest, live_words_empty_range) {
+  mark(70, 10);
+  EXPECT_EQ(words(0), live_words(70, 70));
+  EXPECT_EQ(words(0), live_words(0, 70));
+}
+
+TEST_VM_F(ParMarkBitMapTest, live_words_random) {
+  // Compare with a count over a list of randomly placed objects.
+  const int max_objects = 200;
+  size_t begs[max_objects];
+  size_t sizes[max_objects];
+  int num_objects = 0;
+  for (size_t bit = os::random() % 8; num_objects < max_objects; num_objects++) {
+    size_t size = 1 + os::random() % ((os::random() % 4 == 0) ? 150 : 8);
+    if (bit + size > RegionBits) {
+      break;
+    }
+    mark(bit, size);
+    begs[num_objects] = bit;
+    sizes[num_objects] = size;
+    bit += size + os::random() % 10;
+  }
+  ASSERT_GT(num_objects, 1);
+
+  for (int i = 0; i < 500; i++) {
+    int end_index = os::random() % num_objects;
+    size_t end_obj = begs[end_index];
+    size_t beg = (end_obj == 0) ? 0 : os::random() % (end_obj + 1);
+    size_t expected = 0;
+    for (int j = 0; j < end_index; j++) {
+      if (begs[j] >= beg) {
+        expected += sizes[j];
+      }
+    }
+    ASSERT_EQ(words(expected), live_words(beg, end_obj)) << "beg " << beg << " end_obj " << end_obj;
+  }
+}
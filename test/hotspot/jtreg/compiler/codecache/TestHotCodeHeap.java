@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2024, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package compiler.codecache;
+
+/*
+ * @test TestHotCodeHeap
+ * @summary Test the sizing of the hot code heap and its memory pool.
+ * @requires vm.flagless
+ * @library /test/lib
+ * @modules java.base/jdk.internal.misc
+ *          java.management
+ * @run driver compiler.codecache.TestHotCodeHeap
+ */
+
+import java.lang.management.ManagementFactory;
+import java.lang.management.MemoryPoolMXBean;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+import jdk.test.lib.Asserts;
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+public class TestHotCodeHeap {
+
+    private static final String HOT_POOL = "CodeHeap 'hot nmethods'";
+    private static final long HOT_SIZE = 8 * 1024 * 1024;
+
+    private static OutputAnalyzer run(String... flags) throws Exception {
+        String[] args = new String[flags.length + 4];
+        args[0] = "-XX:+UnlockExperimentalVMOptions";
+        args[1] = "-XX:ReservedCodeCacheSize=240m";
+        args[2] = "-XX:+PrintFlagsFinal";
+        System.arraycopy(flags, 0, args, 3, flags.length);
+        args[args.length - 1] = ListPools.class.getName();
+        OutputAnalyzer output = ProcessTools.executeLimitedTestJava(args);
+        output.shouldHaveExitValue(0);
+        return output;
+    }
+
+    private static long flagValue(OutputAnalyzer output, String flag) {
+        Matcher m = Pattern.compile("\\s" + flag + "\\s+=\\s+(\\d+)").matcher(output.getStdout());
+        Asserts.assertTrue(m.find(), flag + " not printed");
+        return Long.parseLong(m.group(1));
+    }
+
+    public static void main(String[] args) throws Exception {
+        // The hot code heap gets its own memory pool.
+        OutputAnalyzer hot = run("-XX:+SegmentedCodeCache", "-XX:HotCodeHeapSize=" + HOT_SIZE);
+        hot.shouldContain("pool: " + HOT_POOL);
+        hot.shouldNotContain("Hot code heap is disabled");
+        Asserts.assertEQ(flagValue(hot, "HotCodeHeapSize"), HOT_SIZE);
+
+        // It is taken out of the non-profiled code heap.
+        OutputAnalyzer regular = run("-XX:+SegmentedCodeCache");
+        regular.shouldNotContain("pool: " + HOT_POOL);
+        Asserts.assertEQ(flagValue(regular, "NonProfiledCodeHeapSize") - flagValue(hot, "NonProfiledCodeHeapSize"),
+                         HOT_SIZE, "NonProfiledCodeHeapSize must shrink by HotCodeHeapSize");
+        Asserts.assertEQ(flagValue(regular, "ProfiledCodeHeapSize"), flagValue(hot, "ProfiledCodeHeapSize"));
+        Asserts.assertEQ(flagValue(regular, "NonNMethodCodeHeapSize"), flagValue(hot, "NonNMethodCodeHeapSize"));
+
+        // If it does not fit, there is no hot code heap and a warning.
+        OutputAnalyzer too_large = run("-XX:+SegmentedCodeCache", "-XX:HotCodeHeapSize=1g");
+        too_large.shouldContain("does not fit into the non-profiled code heap");
+        too_large.shouldNotContain("pool: " + HOT_POOL);
+        Asserts.assertEQ(flagValue(too_large, "HotCodeHeapSize"), 0L);
+
+        // Without a segmented code cache, the flag is ignored with a warning.
+        OutputAnalyzer unsegmented = run("-XX:-SegmentedCodeCache", "-XX:HotCodeHeapSize=" + HOT_SIZE);
+        unsegmented.shouldContain("HotCodeHeapSize requires SegmentedCodeCache");
+        unsegmented.shouldNotContain("pool: " + HOT_POOL);
+        Asserts.assertEQ(flagValue(unsegmented, "HotCodeHeapSize"), 0L);
+    }
+
+    static class ListPools {
+        public static void main(String[] args) {
+            for (MemoryPoolMXBean pool : ManagementFactory.getMemoryPoolMXBeans()) {
+                System.out.println("pool: " + pool.getName());
+            }
+        }
+    }
+}
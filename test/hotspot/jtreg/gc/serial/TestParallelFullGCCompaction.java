@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2024, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package gc.serial;
+
+/*
+ * @test id=default
+ * @requires vm.gc.Serial
+ * @summary Test that Serial full collections that adjust pointers and compact
+ *          in parallel keep the heap intact.
+ * @library /test/lib
+ * @modules java.base/jdk.internal.misc
+ * @run driver gc.serial.TestParallelFullGCCompaction default
+ */
+
+/*
+ * @test id=threads
+ * @requires vm.gc.Serial
+ * @summary Test parallel Serial full collections with an explicit number of workers.
+ * @library /test/lib
+ * @modules java.base/jdk.internal.misc
+ * @run driver gc.serial.TestParallelFullGCCompaction threads
+ */
+
+import java.util.ArrayList;
+import java.util.List;
+
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+import jtreg.SkippedException;
+
+public class TestParallelFullGCCompaction {
+
+    static class Node {
+        final int id;
+        Node next;
+        Object payload;
+
+        Node(int id) {
+            this.id = id;
+        }
+    }
+
+    private static final int NUM_NODES = 200_000;
+
+    public static void main(String[] args) throws Exception {
+        // The compaction only runs in parallel if more than one CPU is available.
+        if (Runtime.getRuntime().availableProcessors() < 2) {
+            throw new SkippedException("needs at least two CPUs");
+        }
+
+        List<String> opts = new ArrayList<>();
+        opts.add("-XX:+UseSerialGC");
+        opts.add("-Xmx128m");
+        opts.add("-Xmn16m");
+        opts.add("-XX:+UnlockExperimentalVMOptions");
+        opts.add("-XX:+SerialFullGCParallelCompaction");
+        opts.add("-XX:+UnlockDiagnosticVMOptions");
+        opts.add("-XX:+VerifyBeforeGC");
+        opts.add("-XX:+VerifyAfterGC");
+        opts.add("-Xlog:gc+task=info");
+        String expected;
+        switch (args[0]) {
+            case "default":
+                expected = "Using \\d+ workers of \\d+ for full compaction";
+                break;
+            case "threads":
+                opts.add("-XX:ParallelGCThreads=4");
+                expected = "Using [234] workers of 4 for full compaction";
+                break;
+            default:
+                throw new IllegalArgumentException("Unknown mode " + args[0]);
+        }
+        opts.add(Allocator.class.getName());
+
+        OutputAnalyzer output = ProcessTools.executeLimitedTestJava(opts.toArray(new String[0]));
+        output.shouldHaveExitValue(0);
+        output.shouldMatch(expected);
+    }
+
+    static class Allocator {
+        public static void main(String[] args) {
+            // Interleave live and dead objects of varying sizes over several
+            // compaction stripes, so that objects move across stripe boundaries.
+            Node[] nodes = new Node[NUM_NODES];
+            Object[] garbage = new Object[1024];
+            for (int i = 0; i < NUM_NODES; i++) {
+                nodes[i] = new Node(i);
+                nodes[i].payload = (i % 3 == 0) ? new int[i % 100] : new long[i % 7];
+                garbage[i % garbage.length] = new byte[(i * 31) % 256];
+            }
+            // Link the nodes in a shuffled order so references point both ways.
+            for (int i = 0; i < NUM_NODES; i++) {
+                nodes[i].next = nodes[(int)(((long)i * 7919) % NUM_NODES)];
+            }
+            // Drop every other node.
+            Node[] live = new Node[NUM_NODES / 2];
+            for (int i = 0; i < live.length; i++) {
+                live[i] = nodes[i * 2];
+            }
+            nodes = null;
+            garbage = null;
+
+            for (int gc = 0; gc < 3; gc++) {
+                System.gc();
+                verify(live);
+            }
+        }
+    }
+
+    private static void verify(Node[] live) {
+        for (int i = 0; i < live.length; i++) {
+            Node n = live[i];
+            int id = i * 2;
+            if (n.id != id) {
+                throw new RuntimeException("Node " + i + " has id " + n.id + ", expected " + id);
+            }
+            int nextId = (int)(((long)id * 7919) % NUM_NODES);
+            if (n.next.id != nextId) {
+                throw new RuntimeException("Node " + id + " links to " + n.next.id + ", expected " + nextId);
+            }
+            int length = (id % 3 == 0) ? ((int[])n.payload).length : ((long[])n.payload).length;
+            int expected = (id % 3 == 0) ? id % 100 : id % 7;
+            if (length != expected) {
+                throw new RuntimeException("Node " + id + " has payload length " + length + ", expected " + expected);
+            }
+        }
+    }
+}